@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// Writes a synthetic input of any size for one day, see Generators.h
+//
+// Usage: Generate <day> <size> [--seed <n>] [--output <file>]
+//        Generate --list
+//   size accepts K/M/G suffixes; the input goes to stdout unless --output is given
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "Generators.h"
+
+using namespace std;
+
+static uint64_t parseSize(const string &arg) {
+    uint64_t value = stoull(arg);
+    switch (toupper(arg.back())) {
+        case 'G':
+            value <<= 10;
+            [[fallthrough]];
+        case 'M':
+            value <<= 10;
+            [[fallthrough]];
+        case 'K':
+            value <<= 10;
+            break;
+        default:
+            break;
+    }
+    return value;
+}
+
+int main(int argc, char *argv[]) {
+    string day;
+    uint64_t size{};
+    uint64_t seed{1};
+    string output;
+    bool haveSize{false};
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        const auto hasValue = i + 1 < argc;
+        if ("--list" == arg) {
+            for (const auto &generator: aoc::gen::generators) {
+                cout << left << setw(9) << generator.name << generator.size << endl;
+            }
+            return EXIT_SUCCESS;
+        } else if ("--seed" == arg && hasValue) {
+            seed = stoull(argv[++i]);
+        } else if ("--output" == arg && hasValue) {
+            output = argv[++i];
+        } else if (day.empty() && '-' != arg[0]) {
+            day = arg;
+        } else if (!haveSize && '-' != arg[0]) {
+            size = parseSize(arg);
+            haveSize = true;
+        } else {
+            day.clear();
+            break;
+        }
+    }
+    const auto *generator = aoc::gen::find(day);
+    if (nullptr == generator || !haveSize) {
+        cerr << "Usage: " << argv[0] << " <day> <size> [--seed <n>] [--output <file>] | --list" << endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto input = generator->generate(size, seed);
+    if (output.empty()) {
+        cout << input;
+        return EXIT_SUCCESS;
+    }
+    ofstream out(output, ios::binary);
+    if (!out) {
+        cerr << "Cannot open file " << output << endl;
+        return EXIT_FAILURE;
+    }
+    out << input;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,964 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// Synthetic puzzle inputs of configurable size, for scaling benchmarks of every day.
+// Each generator follows the format of the real input and the promises the puzzle text
+// makes about it (a single pipe loop, a rock that hits every hailstone, a three edge cut,
+// ...), so the solvers run unchanged on the result.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "Generators.h"
+
+using namespace std;
+
+namespace {
+
+// splitmix64: unlike the <random> distributions it gives the same stream on every library
+class Random {
+public:
+    explicit Random(uint64_t seed) : state{seed} {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // uniform in [lo, hi]; the modulo bias is far below anything a benchmark can notice
+    int64_t between(int64_t lo, int64_t hi) {
+        return lo + static_cast<int64_t>(next() % static_cast<uint64_t>(hi - lo + 1));
+    }
+
+    bool chance(double p) {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53 < p;
+    }
+
+    char pick(string_view chars) {
+        return chars[between(0, static_cast<int64_t>(chars.size()) - 1)];
+    }
+
+    template<typename T>
+    void shuffle(vector<T> &values) {
+        for (size_t i = values.size(); i > 1; --i) {
+            swap(values[i - 1], values[between(0, static_cast<int64_t>(i) - 1)]);
+        }
+    }
+
+private:
+    uint64_t state;
+};
+
+constexpr string_view lower = "abcdefghijklmnopqrstuvwxyz";
+constexpr string_view upper = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+// count distinct names of minLength..maxLength letters, none of them in reserved; the caller
+// keeps count well below the number of possible names
+vector<string> uniqueNames(Random &random, size_t count, size_t minLength, size_t maxLength,
+                           string_view letters = lower, const set<string> &reserved = {}) {
+    set<string> seen(reserved);
+    vector<string> names;
+    while (names.size() < count) {
+        string name(random.between(static_cast<int64_t>(minLength), static_cast<int64_t>(maxLength)), ' ');
+        for (auto &c: name) {
+            c = random.pick(letters);
+        }
+        if (seen.insert(name).second) {
+            names.push_back(std::move(name));
+        }
+    }
+    return names;
+}
+
+string join(const vector<string> &parts, string_view separator) {
+    string out;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        if (0 != i) {
+            out += separator;
+        }
+        out += parts[i];
+    }
+    return out;
+}
+
+// side x side characters; cell(r, c) picks each one
+template<typename Cell>
+string grid(size_t side, Cell cell) {
+    string out;
+    out.reserve(side * (side + 1));
+    for (size_t r = 0; r < side; ++r) {
+        for (size_t c = 0; c < side; ++c) {
+            out += cell(r, c);
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+struct Point {
+    int64_t x, y;
+};
+
+// Corners, clockwise with y pointing down, of a simple rectilinear polygon over columns of the
+// given widths and [0, height]: a skyline along the top and one along the bottom. The top stays
+// above height / 2 and the bottom below it, so the outline never touches itself.
+vector<Point> skyline(Random &random, const vector<int64_t> &widths, int64_t height) {
+    const auto level = [&](int64_t lo, int64_t hi, int64_t previous) {
+        int64_t y;
+        do {
+            y = random.between(lo, hi);
+        } while (y == previous);
+        return y;
+    };
+    vector<int64_t> xs{0};
+    vector<int64_t> top;
+    vector<int64_t> bottom;
+    for (const auto width: widths) {
+        xs.push_back(xs.back() + width);
+        top.push_back(level(0, height / 2 - 1, top.empty() ? -1 : top.back()));
+        bottom.push_back(level(height / 2 + 1, height, bottom.empty() ? -1 : bottom.back()));
+    }
+
+    const auto columns = widths.size();
+    vector<Point> corners{{xs[0], top[0]}};
+    for (size_t i = 0; i < columns; ++i) {
+        corners.push_back({xs[i + 1], top[i]});
+        if (i + 1 < columns) {
+            corners.push_back({xs[i + 1], top[i + 1]});
+        }
+    }
+    for (size_t i = columns; i-- > 0;) {
+        corners.push_back({xs[i + 1], bottom[i]});
+        corners.push_back({xs[i], bottom[i]});
+    }
+    return corners;
+}
+
+bool isPrime(uint64_t n) {
+    if (n < 2) {
+        return false;
+    }
+    for (uint64_t d = 2; d * d <= n; ++d) {
+        if (0 == n % d) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// the largest prime not above n, or 1
+uint64_t primeBelow(uint64_t n) {
+    while (n > 1 && !isPrime(n)) {
+        --n;
+    }
+    return max<uint64_t>(n, 1);
+}
+
+// size lines of letters and digits, some digits spelled out
+string day1(size_t lines, uint64_t seed) {
+    constexpr array<string_view, 9> words{"one", "two", "three", "four", "five", "six", "seven", "eight", "nine"};
+    Random random(seed);
+    string out;
+    for (size_t i = 0; i < lines; ++i) {
+        string line;
+        for (auto tokens = random.between(2, 8); tokens > 0; --tokens) {
+            switch (random.between(0, 2)) {
+                case 0:
+                    line += random.pick("123456789");
+                    break;
+                case 1:
+                    line += words[random.between(0, words.size() - 1)];
+                    break;
+                default:
+                    for (auto letters = random.between(1, 4); letters > 0; --letters) {
+                        line += random.pick(lower);
+                    }
+                    break;
+            }
+        }
+        if (none_of(line.begin(), line.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)); })) {
+            line.insert(line.begin() + random.between(0, static_cast<int64_t>(line.size())), random.pick("123456789"));
+        }
+        out += line + '\n';
+    }
+    return out;
+}
+
+// size games of one to six draws
+string day2(size_t games, uint64_t seed) {
+    Random random(seed);
+    string out;
+    for (size_t game = 1; game <= games; ++game) {
+        vector<string> draws;
+        for (auto n = random.between(1, 6); n > 0; --n) {
+            vector<string> cubes;
+            for (const string_view color: {"red", "green", "blue"}) {
+                if (cubes.empty() || random.chance(0.6)) {
+                    cubes.push_back(to_string(random.between(1, 20)) + ' ' + string(color));
+                }
+            }
+            random.shuffle(cubes);
+            draws.push_back(join(cubes, ", "));
+        }
+        out += "Game " + to_string(game) + ": " + join(draws, "; ") + '\n';
+    }
+    return out;
+}
+
+// a side x side schematic of part numbers and symbols
+string day3(size_t side, uint64_t seed) {
+    Random random(seed);
+    string out = grid(side, [](size_t, size_t) { return '.'; });
+    const auto stride = side + 1;
+    for (size_t r = 0; r < side; ++r) {
+        for (size_t c = 0; c < side; ++c) {
+            if (const auto digits = static_cast<size_t>(random.between(1, 3)); random.chance(0.12) && c + digits <= side) {
+                out[r * stride + c] = random.pick("123456789");
+                for (size_t d = 1; d < digits; ++d) {
+                    out[r * stride + c + d] = random.pick("0123456789");
+                }
+                c += digits;  // and one '.' after the number
+            } else if (random.chance(0.05)) {
+                out[r * stride + c] = random.pick("**#+$/@%=&-");
+            }
+        }
+    }
+    return out;
+}
+
+// size cards of 10 winning numbers and 25 numbers; no card wins copies past the last one, and
+// fewer than one match per card on average keeps the number of copies linear in size
+string day4(size_t cards, uint64_t seed) {
+    Random random(seed);
+    const auto padded = [](int n) { return (n < 10 ? " " : "") + to_string(n); };
+    const auto width = to_string(cards).size();
+    vector<int> pool(99);
+    iota(pool.begin(), pool.end(), 1);
+    string out;
+    for (size_t card = 1; card <= cards; ++card) {
+        random.shuffle(pool);
+        const auto wins = random.chance(0.75) ? 0 : random.chance(0.8) ? random.between(1, 2) : random.between(3, 10);
+        const auto matches = min<int64_t>(wins, static_cast<int64_t>(cards - card));
+        vector<int> numbers(pool.begin(), pool.begin() + matches);
+        numbers.insert(numbers.end(), pool.begin() + 10, pool.begin() + 10 + (25 - matches));
+        random.shuffle(numbers);
+
+        const auto id = to_string(card);
+        out += "Card " + string(width - id.size(), ' ') + id + ":";
+        for (size_t i = 0; i < 10; ++i) {
+            out += ' ' + padded(pool[i]);
+        }
+        out += " |";
+        for (const auto n: numbers) {
+            out += ' ' + padded(n);
+        }
+        out += '\n';
+    }
+    return out;
+}
+
+// size seed ranges through the seven maps, each one a shuffle of 32 intervals
+string day5(size_t ranges, uint64_t seed) {
+    constexpr array<string_view, 7> names{"seed-to-soil", "soil-to-fertilizer", "fertilizer-to-water", "water-to-light",
+                                          "light-to-temperature", "temperature-to-humidity", "humidity-to-location"};
+    constexpr int64_t limit = int64_t{1} << 32;
+    constexpr size_t intervals = 32;
+    Random random(seed);
+    ranges = max<size_t>(ranges, 1);
+
+    vector<string> seeds;
+    for (size_t i = 0; i < ranges; ++i) {
+        const auto length = random.between(1, max<int64_t>(1, limit / static_cast<int64_t>(2 * ranges)));
+        seeds.push_back(to_string(random.between(0, limit - length)) + ' ' + to_string(length));
+    }
+    string out = "seeds: " + join(seeds, " ") + '\n';
+
+    for (const auto name: names) {
+        set<int64_t> cuts{0, limit};
+        while (cuts.size() < intervals + 1) {
+            cuts.insert(random.between(1, limit - 1));
+        }
+        const vector<int64_t> bounds(cuts.begin(), cuts.end());
+        vector<size_t> order(intervals);
+        iota(order.begin(), order.end(), 0);
+        random.shuffle(order);
+
+        out += '\n' + string(name) + " map:\n";
+        int64_t destination = 0;
+        for (const auto i: order) {
+            const auto length = bounds[i + 1] - bounds[i];
+            if (random.chance(0.9)) {  // the rest is left to the identity mapping
+                out += to_string(destination) + ' ' + to_string(bounds[i]) + ' ' + to_string(length) + '\n';
+            }
+            destination += length;
+        }
+    }
+    return out;
+}
+
+// size races, at most four: Part 2 reads all the digits as one 64-bit number
+string day6(size_t races, uint64_t seed) {
+    Random random(seed);
+    string times = "Time:";
+    string distances = "Distance:";
+    for (size_t i = 0; i < clamp<size_t>(races, 1, 4); ++i) {
+        const auto time = random.between(7, 99);
+        const auto hold = random.between(1, time / 2 - 1);  // holding one longer beats the record
+        times += "     " + to_string(time);
+        distances += "   " + to_string(hold * (time - hold));
+    }
+    return times + '\n' + distances + '\n';
+}
+
+// size hands with their bids
+string day7(size_t hands, uint64_t seed) {
+    Random random(seed);
+    string out;
+    for (size_t i = 0; i < hands; ++i) {
+        for (int card = 0; card < 5; ++card) {
+            out += random.pick("23456789TJQKA");
+        }
+        out += ' ' + to_string(random.between(1, 1000)) + '\n';
+    }
+    return out;
+}
+
+// about size nodes, at most 16000, in six loops; every loop reaches its Z node after a multiple of
+// the instruction length, as in the puzzle, so the LCM of the first arrivals is the answer
+string day8(size_t nodes, uint64_t seed) {
+    Random random(seed);
+    nodes = clamp<size_t>(nodes, 8, 16000);
+    const size_t ghosts = min<size_t>(6, nodes / 4);
+    const auto budget = nodes / ghosts;
+    const auto length = primeBelow(static_cast<uint64_t>(sqrt(static_cast<double>(budget))));
+
+    string instructions;
+    for (uint64_t i = 0; i < length; ++i) {
+        instructions += random.pick("LR");
+    }
+
+    // middle nodes never end in A or Z
+    auto starts = uniqueNames(random, ghosts - 1, 2, 2, upper, {"AA", "ZZ"});
+    auto names = uniqueNames(random, nodes, 3, 3, "BCDEFGHIJKLMNOPQRSTUVWXY");
+    vector<string> lines;
+    uint64_t prime = max<uint64_t>(budget / length, 2) + 1;
+    for (size_t ghost = 0; ghost < ghosts; ++ghost) {
+        prime = primeBelow(prime - 1);
+        const auto steps = length * prime;
+        // the first loop runs from AAA to ZZZ for Part 1
+        vector<string> loop{0 == ghost ? "AAA" : starts[ghost - 1] + 'A'};
+        for (uint64_t i = 1; i < steps && !names.empty(); ++i) {
+            loop.push_back(names.back());
+            names.pop_back();
+        }
+        loop.push_back(0 == ghost ? "ZZZ" : starts[ghost - 1] + 'Z');
+        for (size_t i = 0; i + 1 < loop.size(); ++i) {
+            lines.push_back(loop[i] + " = (" + loop[i + 1] + ", " + loop[i + 1] + ")");
+        }
+        const auto &back = loop.size() > 2 ? loop[1] : loop.back();
+        lines.push_back(loop.back() + " = (" + back + ", " + back + ")");
+    }
+    random.shuffle(lines);
+    return instructions + "\n\n" + join(lines, "\n") + '\n';
+}
+
+// size sequences of 21 values of a polynomial of degree one to eight
+string day9(size_t sequences, uint64_t seed) {
+    Random random(seed);
+    string out;
+    for (size_t i = 0; i < sequences; ++i) {
+        // the first value of every difference row; the last row is constant
+        vector<int64_t> rows(random.between(2, 9));
+        for (auto &row: rows) {
+            row = random.between(-20, 20);
+        }
+        rows.back() = random.between(-3, 3);
+        vector<string> values;
+        for (int n = 0; n < 21; ++n) {
+            values.push_back(to_string(rows[0]));
+            for (size_t k = 0; k + 1 < rows.size(); ++k) {
+                rows[k] += rows[k + 1];
+            }
+        }
+        out += join(values, " ") + '\n';
+    }
+    return out;
+}
+
+// a side x side field of junk pipes around one loop through S
+string day10(size_t side, uint64_t seed) {
+    enum Side : uint8_t { N = 1, E = 2, S = 4, W = 8 };
+    Random random(seed);
+    side = max<size_t>(side, 8);
+    const auto stride = static_cast<int64_t>(side) + 1;
+    string out = grid(side, [&](size_t, size_t) { return random.pick("|-LJ7F...."); });
+
+    // the loop keeps a margin of one tile on every side
+    const auto inner = static_cast<int64_t>(side) - 3;
+    vector<int64_t> widths;
+    for (int64_t x = 0; x < inner; x += widths.back()) {
+        widths.push_back(min(inner - x, random.between(1, 3)));
+    }
+    auto corners = skyline(random, widths, inner);
+    for (auto &p: corners) {
+        p = {p.x + 1, p.y + 1};
+    }
+
+    vector<int64_t> loop;
+    vector<uint8_t> sides;
+    const auto towards = [](const Point &from, const Point &to) -> uint8_t {
+        return to.x > from.x ? E : to.x < from.x ? W : to.y > from.y ? S : N;
+    };
+    const auto opposite = [](uint8_t side) -> uint8_t { return side < S ? side << 2 : side >> 2; };
+    for (size_t i = 0; i < corners.size(); ++i) {
+        const auto &from = corners[i];
+        const auto &to = corners[(i + 1) % corners.size()];
+        const auto &before = corners[(i + corners.size() - 1) % corners.size()];
+        const auto dir = towards(from, to);
+        const Point step{to.x > from.x ? 1 : to.x < from.x ? -1 : 0, to.y > from.y ? 1 : to.y < from.y ? -1 : 0};
+        for (Point p = from; p.x != to.x || p.y != to.y; p = {p.x + step.x, p.y + step.y}) {
+            loop.push_back(p.y * stride + p.x);
+            sides.push_back(p.x == from.x && p.y == from.y ? opposite(towards(before, from)) | dir : opposite(dir) | dir);
+        }
+    }
+    for (size_t i = 0; i < loop.size(); ++i) {
+        switch (sides[i]) {
+            case N | S: out[loop[i]] = '|'; break;
+            case E | W: out[loop[i]] = '-'; break;
+            case N | E: out[loop[i]] = 'L'; break;
+            case N | W: out[loop[i]] = 'J'; break;
+            case S | W: out[loop[i]] = '7'; break;
+            default: out[loop[i]] = 'F'; break;
+        }
+    }
+
+    // no junk pipe may lead into S
+    const auto start = static_cast<size_t>(random.between(0, static_cast<int64_t>(loop.size()) - 1));
+    out[loop[start]] = 'S';
+    const unordered_set<int64_t> onLoop(loop.begin(), loop.end());
+    for (const auto adj: {loop[start] - stride, loop[start] + stride, loop[start] - 1, loop[start] + 1}) {
+        if (0 == onLoop.count(adj) && '\n' != out[adj]) {
+            out[adj] = '.';
+        }
+    }
+    return out;
+}
+
+// a side x side image with 2% galaxies and about 5% empty rows and columns
+string day11(size_t side, uint64_t seed) {
+    Random random(seed);
+    vector<bool> emptyRow(side);
+    vector<bool> emptyCol(side);
+    for (size_t i = 0; i < side; ++i) {
+        emptyRow[i] = random.chance(0.05);
+        emptyCol[i] = random.chance(0.05);
+    }
+    return grid(side, [&](size_t r, size_t c) {
+        return !emptyRow[r] && !emptyCol[c] && random.chance(0.02) ? '#' : '.';
+    });
+}
+
+// size rows of 6 to 20 springs, about 45% of them unknown
+string day12(size_t rows, uint64_t seed) {
+    Random random(seed);
+    string out;
+    for (size_t i = 0; i < rows; ++i) {
+        string springs(random.between(6, 20), '.');
+        for (auto &spring: springs) {
+            spring = random.chance(0.45) ? '#' : '.';
+        }
+        springs[random.between(0, static_cast<int64_t>(springs.size()) - 1)] = '#';
+
+        vector<string> groups;
+        for (size_t c = 0; c < springs.size();) {
+            const auto end = springs.find('.', c);
+            const auto length = (string::npos == end ? springs.size() : end) - c;
+            if (length > 0) {
+                groups.push_back(to_string(length));
+            }
+            c += length + 1;
+        }
+        for (auto &spring: springs) {
+            if (random.chance(0.45)) {
+                spring = '?';
+            }
+        }
+        out += springs + ' ' + join(groups, ",") + '\n';
+    }
+    return out;
+}
+
+// Differences across every horizontal line of reflection, then across every vertical one
+vector<size_t> reflections(const vector<string> &pattern) {
+    vector<size_t> diffs;
+    const auto rows = pattern.size();
+    const auto cols = pattern[0].size();
+    for (size_t line = 1; line < rows; ++line) {
+        size_t diff{};
+        for (size_t i = 0; i < min(line, rows - line); ++i) {
+            for (size_t c = 0; c < cols; ++c) {
+                diff += pattern[line - 1 - i][c] != pattern[line + i][c] ? 1 : 0;
+            }
+        }
+        diffs.push_back(diff);
+    }
+    for (size_t line = 1; line < cols; ++line) {
+        size_t diff{};
+        for (size_t i = 0; i < min(line, cols - line); ++i) {
+            for (size_t r = 0; r < rows; ++r) {
+                diff += pattern[r][line - 1 - i] != pattern[r][line + i] ? 1 : 0;
+            }
+        }
+        diffs.push_back(diff);
+    }
+    return diffs;
+}
+
+// size patterns, each with exactly one line of reflection and exactly one more that is off by a
+// single smudge
+string day13(size_t patterns, uint64_t seed) {
+    Random random(seed);
+    vector<string> out;
+    while (out.size() < patterns) {
+        const auto rows = random.between(5, 17);
+        const auto cols = random.between(5, 17);
+        const auto perfect = random.between(1, rows - 1);
+        const auto smudged = random.between(1, rows - 1);
+        // the rows each line reflects may not overlap, or the two lines would make the pattern periodic
+        const auto reach = [&](int64_t line) { return min(line, rows - line); };
+        if (perfect - reach(perfect) < smudged + reach(smudged) && smudged - reach(smudged) < perfect + reach(perfect)) {
+            continue;
+        }
+
+        vector<string> pattern(rows, string(cols, '.'));
+        for (auto &row: pattern) {
+            for (auto &c: row) {
+                c = random.pick("#.");
+            }
+        }
+        for (const auto line: {perfect, smudged}) {
+            for (int64_t i = 0; i < reach(line); ++i) {
+                pattern[line + i] = pattern[line - 1 - i];
+            }
+        }
+        auto &cell = pattern[smudged + random.between(0, reach(smudged) - 1)][random.between(0, cols - 1)];
+        cell = '#' == cell ? '.' : '#';
+
+        if (random.chance(0.5)) {  // turn the lines of reflection vertical
+            vector<string> transposed(cols, string(rows, ' '));
+            for (int64_t r = 0; r < rows; ++r) {
+                for (int64_t c = 0; c < cols; ++c) {
+                    transposed[c][r] = pattern[r][c];
+                }
+            }
+            pattern = std::move(transposed);
+        }
+        const auto diffs = reflections(pattern);
+        if (1 != count(diffs.begin(), diffs.end(), 0) || 1 != count(diffs.begin(), diffs.end(), 1)) {
+            continue;
+        }
+        out.push_back(join(pattern, "\n") + '\n');
+    }
+    return join(out, "\n");
+}
+
+// a side x side platform of 20% round and 15% cube rocks
+string day14(size_t side, uint64_t seed) {
+    Random random(seed);
+    return grid(side, [&](size_t, size_t) { return random.pick("OOOO###..........."); });
+}
+
+// size steps over size / 8 labels of two to six letters
+string day15(size_t steps, uint64_t seed) {
+    Random random(seed);
+    const auto labels = uniqueNames(random, max<size_t>(1, steps / 8), 2, 6);
+    vector<string> sequence;
+    for (size_t i = 0; i < steps; ++i) {
+        const auto &label = labels[random.between(0, static_cast<int64_t>(labels.size()) - 1)];
+        sequence.push_back(random.chance(0.6) ? label + '=' + random.pick("123456789") : label + '-');
+    }
+    return join(sequence, ",") + '\n';
+}
+
+// a side x side contraption with 10% mirrors and splitters
+string day16(size_t side, uint64_t seed) {
+    Random random(seed);
+    return grid(side, [&](size_t, size_t) { return random.chance(0.1) ? random.pick("/\\|-") : '.'; });
+}
+
+// a side x side map of heat losses
+string day17(size_t side, uint64_t seed) {
+    Random random(seed);
+    return grid(side, [&](size_t, size_t) { return random.pick("123456789"); });
+}
+
+// about size instructions; the colors trace a second, far larger loop over as many columns
+string day18(size_t instructions, uint64_t seed) {
+    Random random(seed);
+    const auto columns = static_cast<int64_t>(max<size_t>(instructions / 4, 1));
+    // both shoelace sums have to fit in 64 bits
+    constexpr int64_t height = 1'000'000;
+    const auto maxColumn = clamp<int64_t>(1'000'000'000'000 / (columns * columns), 1, 500'000);
+
+    vector<int64_t> smallWidths(columns);
+    vector<int64_t> largeWidths(columns);
+    for (int64_t i = 0; i < columns; ++i) {
+        smallWidths[i] = random.between(1, 10);
+        largeWidths[i] = random.between(1, 2 * maxColumn);
+    }
+    const auto small = skyline(random, smallWidths, 40);
+    const auto large = skyline(random, largeWidths, height);
+
+    const auto edge = [](const Point &from, const Point &to) -> pair<int, int64_t> {
+        if (to.x != from.x) {
+            return {to.x > from.x ? 0 : 2, abs(to.x - from.x)};
+        }
+        return {to.y > from.y ? 1 : 3, abs(to.y - from.y)};
+    };
+    constexpr string_view hex = "0123456789abcdef";
+    string out;
+    for (size_t i = 0; i < small.size(); ++i) {
+        const auto [dir, length] = edge(small[i], small[(i + 1) % small.size()]);
+        const auto [color, distance] = edge(large[i], large[(i + 1) % large.size()]);
+        out += "RDLU"[dir];
+        out += ' ' + to_string(length) + " (#";
+        for (int shift = 16; shift >= 0; shift -= 4) {
+            out += hex[(distance >> shift) & 0xf];
+        }
+        out += hex[color];
+        out += ")\n";
+    }
+    return out;
+}
+
+// size workflows in a tree below "in", and as many parts
+string day19(size_t workflows, uint64_t seed) {
+    Random random(seed);
+    workflows = max<size_t>(workflows, 1);
+    auto names = uniqueNames(random, workflows - 1, 2, 3, lower, {"in"});
+    names.insert(names.begin(), "in");
+
+    vector<string> lines;
+    size_t next = 1;
+    for (size_t i = 0; i < workflows; ++i) {
+        const auto targets = random.between(2, 4);
+        vector<string> rules;
+        for (int64_t t = 0; t < targets; ++t) {
+            // every workflow has to be used before the queue of the tree runs dry
+            const auto last = t + 1 == targets;
+            string target;
+            if (next < workflows && (random.chance(0.6) || (last && next == i + 1))) {
+                target = names[next++];
+            } else {
+                target = random.chance(0.5) ? "A" : "R";
+            }
+            if (last) {
+                rules.push_back(target);
+            } else {
+                rules.push_back(string(1, random.pick("xmas")) + random.pick("<>") + to_string(random.between(1, 4000)) + ':' + target);
+            }
+        }
+        lines.push_back(names[i] + '{' + join(rules, ",") + '}');
+    }
+    random.shuffle(lines);
+
+    string out = join(lines, "\n") + "\n\n";
+    for (size_t i = 0; i < workflows; ++i) {
+        out += "{x=" + to_string(random.between(1, 4000)) + ",m=" + to_string(random.between(1, 4000)) +
+               ",a=" + to_string(random.between(1, 4000)) + ",s=" + to_string(random.between(1, 4000)) + "}\n";
+    }
+    return out;
+}
+
+// about size modules: four chains of flip-flops counting up to a conjunction, as in the puzzle,
+// all feeding rx
+string day20(size_t modules, uint64_t seed) {
+    Random random(seed);
+    modules = max<size_t>(modules, 16);
+    const size_t chains = clamp<size_t>(modules / 12, 1, 4);
+    const auto length = max<size_t>(2, (modules - 2) / chains - 2);
+    auto names = uniqueNames(random, chains * (length + 2) + 1, 2, 3, lower, {"rx"});
+    const auto take = [&names] {
+        auto name = names.back();
+        names.pop_back();
+        return name;
+    };
+
+    vector<string> lines;
+    vector<string> firsts;
+    vector<string> inverters;
+    const auto output = take();
+    for (size_t chain = 0; chain < chains; ++chain) {
+        vector<string> flipFlops(length);
+        generate(flipFlops.begin(), flipFlops.end(), take);
+        const auto hub = take();
+        inverters.push_back(take());
+        firsts.push_back(flipFlops[0]);
+
+        vector<string> fromHub{inverters.back()};
+        for (size_t i = 0; i < length; ++i) {
+            vector<string> outputs;
+            if (i + 1 < length) {
+                outputs.push_back(flipFlops[i + 1]);
+            }
+            if (0 == i || i + 1 == length || random.chance(0.5)) {
+                outputs.push_back(hub);
+            }
+            if (0 == i || outputs.size() == 1) {
+                fromHub.push_back(flipFlops[i]);
+            }
+            lines.push_back('%' + flipFlops[i] + " -> " + join(outputs, ", "));
+        }
+        lines.push_back('&' + hub + " -> " + join(fromHub, ", "));
+        lines.push_back('&' + inverters.back() + " -> " + output);
+    }
+    lines.push_back('&' + output + " -> rx");
+    lines.push_back("broadcaster -> " + join(firsts, ", "));
+    random.shuffle(lines);
+    return join(lines, "\n") + '\n';
+}
+
+// an odd side x side garden, at most 255, with S in the middle of a clear row and column
+string day21(size_t side, uint64_t seed) {
+    Random random(seed);
+    side = clamp<size_t>(side | 1, 11, 255);
+    const auto middle = side / 2;
+    return grid(side, [&](size_t r, size_t c) {
+        if (r == middle && c == middle) {
+            return 'S';
+        }
+        const auto clear = r == middle || c == middle || 0 == r || 0 == c || side - 1 == r || side - 1 == c;
+        return !clear && random.chance(0.12) ? '#' : '.';
+    });
+}
+
+// size bricks, at most 65535, of up to five cubes over a 10 x 10 floor, none overlapping
+string day22(size_t bricks, uint64_t seed) {
+    Random random(seed);
+    bricks = min<size_t>(bricks, 65535);
+    const auto height = static_cast<int64_t>(bricks / 4 + 10);
+    unordered_set<int64_t> occupied;
+    const auto key = [](const array<int64_t, 3> &cube) { return (cube[2] * 10 + cube[1]) * 10 + cube[0]; };
+
+    string out;
+    for (size_t i = 0; i < bricks;) {
+        const auto axis = random.between(0, 2);
+        array<int64_t, 3> from{random.between(0, 9), random.between(0, 9), random.between(1, height)};
+        auto to = from;
+        to[axis] = min<int64_t>(from[axis] + random.between(0, 4), 2 == axis ? height + 4 : 9);
+
+        vector<int64_t> cubes;
+        for (auto cube = from; cube[axis] <= to[axis]; ++cube[axis]) {
+            cubes.push_back(key(cube));
+        }
+        if (any_of(cubes.begin(), cubes.end(), [&](int64_t k) { return occupied.count(k) > 0; })) {
+            continue;
+        }
+        occupied.insert(cubes.begin(), cubes.end());
+        out += to_string(from[0]) + ',' + to_string(from[1]) + ',' + to_string(from[2]) + '~' +
+               to_string(to[0]) + ',' + to_string(to[1]) + ',' + to_string(to[2]) + '\n';
+        ++i;
+    }
+    return out;
+}
+
+// a size x size lattice of junctions, at most 60, joined by straight trails inside at most 255 x 255
+// tiles; as in the puzzle every trail next to a junction is a slope leading right or down
+string day23(size_t junctions, uint64_t seed) {
+    Random random(seed);
+    const auto k = clamp<size_t>(junctions, 2, 60);
+    const auto maxGap = max<int64_t>(4, min<int64_t>(24, 248 / static_cast<int64_t>(k)));
+    const auto lines = [&](int64_t first) {
+        vector<int64_t> at{first};
+        while (at.size() < k) {
+            at.push_back(at.back() + random.between(4, maxGap));
+        }
+        return at;
+    };
+    const auto rows = lines(random.between(2, 4));
+    const auto cols = lines(1);
+    const auto side = static_cast<size_t>(max(rows.back(), cols.back()) + 4);
+
+    vector<string> map(side, string(side, '#'));
+    for (int64_t r = 0; r < rows[0]; ++r) {
+        map[r][1] = r + 1 == rows[0] ? 'v' : '.';
+    }
+    for (size_t i = 0; i < k; ++i) {
+        for (size_t j = 0; j < k; ++j) {
+            const auto r = rows[i];
+            const auto c = cols[j];
+            map[r][c] = '.';
+            if (j + 1 < k) {
+                for (auto cc = c + 1; cc < cols[j + 1]; ++cc) {
+                    map[r][cc] = cc == c + 1 || cc + 1 == cols[j + 1] ? '>' : '.';
+                }
+            }
+            if (i + 1 < k) {
+                for (auto rr = r + 1; rr < rows[i + 1]; ++rr) {
+                    map[rr][c] = rr == r + 1 || rr + 1 == rows[i + 1] ? 'v' : '.';
+                }
+            }
+        }
+    }
+    // from the last junction right and down to the exit in the bottom row
+    const auto last = rows.back();
+    for (auto c = cols.back() + 1; c < static_cast<int64_t>(side) - 1; ++c) {
+        map[last][c] = c == cols.back() + 1 ? '>' : '.';
+    }
+    for (auto r = last + 1; r < static_cast<int64_t>(side); ++r) {
+        map[r][side - 2] = '.';
+    }
+    return join(map, "\n") + '\n';
+}
+
+// size hailstones, at least 3 since the rock is found from three of them, all hit by one rock
+// thrown with a velocity inside +-250
+string day24(size_t hailstones, uint64_t seed) {
+    Random random(seed);
+    hailstones = max<size_t>(hailstones, 3);
+    const array<int64_t, 3> rock{random.between(250'000'000'000'000, 350'000'000'000'000),
+                                 random.between(250'000'000'000'000, 350'000'000'000'000),
+                                 random.between(250'000'000'000'000, 350'000'000'000'000)};
+    const array<int64_t, 3> throwing{random.between(-250, 250), random.between(-250, 250), random.between(-250, 250)};
+
+    set<int64_t> times;
+    string out;
+    while (times.size() < hailstones) {
+        const auto time = random.between(10'000'000'000, 400'000'000'000);
+        if (!times.insert(time).second) {
+            continue;
+        }
+        array<int64_t, 3> velocity{};
+        do {
+            for (auto &v: velocity) {
+                v = random.between(-300, 300);
+            }
+        } while (velocity == throwing);
+        array<int64_t, 3> position{};
+        for (int i = 0; i < 3; ++i) {
+            position[i] = rock[i] + (throwing[i] - velocity[i]) * time;
+        }
+        out += to_string(position[0]) + ", " + to_string(position[1]) + ", " + to_string(position[2]) + " @ " +
+               to_string(velocity[0]) + ", " + to_string(velocity[1]) + ", " + to_string(velocity[2]) + '\n';
+    }
+    return out;
+}
+
+// size components, 12 to 17576, in two halves that only three wires join. A component needs four
+// partners in its half, so halves of 5 would do; 12 leaves room for the three wires between them
+string day25(size_t components, uint64_t seed) {
+    Random random(seed);
+    components = clamp<size_t>(components, 12, 17576);
+    const auto names = uniqueNames(random, components, 3, 3);
+    const auto half = static_cast<int64_t>(components / 2);
+
+    // four wires on every component keep each half far better connected than three wires;
+    // those earlier components attached count, or the last ones of a small half run out of partners
+    set<pair<int64_t, int64_t>> wires;
+    vector<int> degree(components);
+    const auto connect = [&](int64_t a, int64_t b) {
+        if (a == b || !wires.insert({min(a, b), max(a, b)}).second) {
+            return false;
+        }
+        ++degree[a];
+        ++degree[b];
+        return true;
+    };
+    for (int64_t a = 0; a < static_cast<int64_t>(components); ++a) {
+        const auto lo = a < half ? 0 : half;
+        const auto hi = a < half ? half - 1 : static_cast<int64_t>(components) - 1;
+        while (degree[a] < 4) {
+            connect(a, random.between(lo, hi));
+        }
+    }
+    for (int added = 0; added < 3;) {
+        added += connect(random.between(0, half - 1), random.between(half, static_cast<int64_t>(components) - 1)) ? 1 : 0;
+    }
+
+    vector<vector<string>> connected(components);
+    for (const auto &[a, b]: wires) {
+        const auto listed = random.chance(0.5);
+        connected[listed ? a : b].push_back(names[listed ? b : a]);
+    }
+    vector<string> lines;
+    for (size_t i = 0; i < components; ++i) {
+        if (!connected[i].empty()) {
+            lines.push_back(names[i] + ": " + join(connected[i], " "));
+        }
+    }
+    random.shuffle(lines);
+    return join(lines, "\n") + '\n';
+}
+
+}  // namespace
+
+namespace aoc::gen {
+
+const std::array<Generator, 26> generators{{
+        {"Day_1", "lines", day1},
+        {"Day_2", "games", day2},
+        {"Day_3", "side of the schematic", day3},
+        {"Day_4", "cards", day4},
+        {"Day_5", "seed ranges", day5},
+        {"Day_6", "races (at most 4)", day6},
+        {"Day_7", "hands", day7},
+        {"Day_8", "nodes (at most 16000)", day8},
+        {"Day_9", "sequences", day9},
+        {"Day_10", "side of the field", day10},
+        {"Day_11", "side of the image", day11},
+        {"Day_12", "rows", day12},
+        {"Day_13", "patterns", day13},
+        {"Day_14", "side of the platform", day14},
+        {"Day_15", "steps", day15},
+        {"Day_16", "side of the contraption", day16},
+        {"Day_17", "side of the map", day17},
+        {"Day_18", "instructions", day18},
+        {"Day_19", "workflows and parts", day19},
+        {"Day_20", "modules", day20},
+        {"Day_21", "side of the garden (odd, at most 255)", day21},
+        {"Day_22", "bricks", day22},
+        {"Day_23", "junctions per side (at most 60)", day23},
+        {"Day_23B", "junctions per side (at most 60)", day23},
+        {"Day_24", "hailstones (at least 3)", day24},
+        {"Day_25", "components (12 to 17576)", day25},
+}};
+
+const Generator *find(std::string_view name) {
+    for (const auto &generator: generators) {
+        if (name == generator.name || "Day_" + std::string(name) == generator.name) {
+            return &generator;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace aoc::gen
@@ -0,0 +1,53 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// Synthetic puzzle inputs of configurable size, for scaling benchmarks of every day
+
+#ifndef AOC_BENCHMARKS_GENERATORS_H
+#define AOC_BENCHMARKS_GENERATORS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace aoc::gen {
+
+// Builds a valid input for one day; the same size and seed always give the same text
+using GenerateFn = std::string (*)(std::size_t size, std::uint64_t seed);
+
+struct Generator {
+    std::string_view name;  // directory of the day, e.g. "Day_9", as in aoc::solutions
+    std::string_view size;  // what the size parameter counts
+    GenerateFn generate;
+};
+
+extern const std::array<Generator, 26> generators;
+
+// The generator of the named day ("Day_9" or "9"), or nullptr
+const Generator *find(std::string_view name);
+
+}  // namespace aoc::gen
+
+#endif  // AOC_BENCHMARKS_GENERATORS_H
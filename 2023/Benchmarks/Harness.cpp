@@ -0,0 +1,422 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// Benchmark harness: runs every day's Part 1 and Part 2 in-process and reports latency
+// percentiles, heap allocations and peak RSS, as a table or as JSON.
+//
+// Usage: Harness [--day <name>]... [--reps <n>] [--warmup <n>] [--max-seconds <s>]
+//                [--root <dir>] [--json <file>|-] [--counters <file>|-] [--trace <file>]
+//                [--size <n>]... [--seed <n>] [--no-arena]
+//
+// --size runs every day on inputs built by Generators.h instead of the puzzle input, once per
+// size, to chart runtime and memory against the size of the input. A day whose generator or
+// solver throws is reported on cerr and skipped.
+// --counters and --trace export the instrumentation of Common/Trace.h, which is only
+// compiled in when the build was configured with -DAOC_ENABLE_TRACE=ON.
+// --no-arena sends the solvers that use Common/Arena.h straight to the heap, to compare
+// allocation counts with and without the arena.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+#include "../Common/Arena.h"
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
+#include "../Common/Trace.h"
+#include "Generators.h"
+
+#ifndef AOC_SOURCE_DIR
+#define AOC_SOURCE_DIR "."
+#endif
+#ifndef AOC_REVISION
+#define AOC_REVISION "unknown"
+#endif
+#ifndef AOC_BUILD_TYPE
+#define AOC_BUILD_TYPE "unknown"
+#endif
+
+using namespace std;
+
+// Every heap allocation in the process goes through these counters
+static atomic<uint64_t> allocations{0};
+static atomic<uint64_t> allocatedBytes{0};
+
+static void *countedAlloc(size_t size) noexcept {
+    allocations.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+    return malloc(0 == size ? 1 : size);
+}
+
+static void *countedAlignedAlloc(size_t size, align_val_t align) noexcept {
+    allocations.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+    const auto alignment = max(static_cast<size_t>(align), sizeof(void *));
+#ifdef _WIN32
+    return _aligned_malloc(0 == size ? 1 : size, alignment);
+#else
+    void *p = nullptr;
+    return 0 == posix_memalign(&p, alignment, 0 == size ? 1 : size) ? p : nullptr;
+#endif
+}
+
+static void alignedFree(void *p) noexcept {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+void *operator new(size_t size) {
+    if (void *p = countedAlloc(size)) {
+        return p;
+    }
+    throw bad_alloc();
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void *operator new(size_t size, const nothrow_t &) noexcept {
+    return countedAlloc(size);
+}
+
+void *operator new[](size_t size, const nothrow_t &) noexcept {
+    return countedAlloc(size);
+}
+
+void *operator new(size_t size, align_val_t align) {
+    if (void *p = countedAlignedAlloc(size, align)) {
+        return p;
+    }
+    throw bad_alloc();
+}
+
+void *operator new[](size_t size, align_val_t align) {
+    return operator new(size, align);
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, align_val_t) noexcept {
+    alignedFree(p);
+}
+
+void operator delete[](void *p, align_val_t) noexcept {
+    alignedFree(p);
+}
+
+void operator delete(void *p, size_t, align_val_t) noexcept {
+    alignedFree(p);
+}
+
+void operator delete[](void *p, size_t, align_val_t) noexcept {
+    alignedFree(p);
+}
+
+// High-water mark of the resident set of the whole process, in KiB
+static uint64_t peakRss() {
+#ifdef _WIN32
+    return 0;
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss) / 1024;
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+struct Options {
+    vector<string> days;
+    int reps{10};
+    int warmup{1};
+    double maxSeconds{10};
+    filesystem::path root{AOC_SOURCE_DIR};
+    string json;
+    string counters;
+    string trace;
+    vector<size_t> sizes;
+    uint64_t seed{1};
+    bool arena{true};
+};
+
+struct Measurement {
+    string day;
+    int part{};
+    size_t size{};  // of the generated input; 0 for the puzzle input
+    aoc::Answer answer{};
+    vector<double> nanos{};
+    uint64_t allocations{};
+    uint64_t bytes{};
+    uint64_t peakRssKb{};
+
+    // nearest-rank percentile
+    [[nodiscard]] double percentile(double p) const {
+        auto sorted = nanos;
+        sort(sorted.begin(), sorted.end());
+        const auto rank = static_cast<size_t>(max(1.0, ceil(p / 100. * static_cast<double>(sorted.size()))));
+        return sorted[rank - 1];
+    }
+};
+
+static bool selected(const Options &options, const aoc::Solution &solution) {
+    if (options.days.empty()) {
+        return true;
+    }
+    return any_of(options.days.begin(), options.days.end(), [&](const string &day) {
+        return day == solution.name || "Day_" + day == solution.name;
+    });
+}
+
+static Measurement measure(const aoc::Solution &solution, int part, string_view input, const Options &options) {
+    const auto solve = 1 == part ? solution.part1 : solution.part2;
+    Measurement m{string(solution.name), part};
+
+    for (int i = 0; i < options.warmup; ++i) {
+        m.answer = solve(input);
+    }
+
+    uint64_t totalAllocations{};
+    uint64_t totalBytes{};
+    double elapsed{};
+    for (int i = 0; i < options.reps && (0 == i || elapsed < options.maxSeconds); ++i) {
+        const auto allocationsBefore = allocations.load(memory_order_relaxed);
+        const auto bytesBefore = allocatedBytes.load(memory_order_relaxed);
+        const auto start = chrono::steady_clock::now();
+        m.answer = solve(input);
+        const auto stop = chrono::steady_clock::now();
+        totalAllocations += allocations.load(memory_order_relaxed) - allocationsBefore;
+        totalBytes += allocatedBytes.load(memory_order_relaxed) - bytesBefore;
+
+        const chrono::duration<double, nano> nanos = stop - start;
+        m.nanos.push_back(nanos.count());
+        elapsed += nanos.count() * 1e-9;
+    }
+    m.allocations = totalAllocations / m.nanos.size();
+    m.bytes = totalBytes / m.nanos.size();
+    m.peakRssKb = peakRss();
+    return m;
+}
+
+static string escape(const string &s) {
+    string out;
+    for (const char c: s) {
+        if ('"' == c || '\\' == c) {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out;
+}
+
+static void writeJson(ostream &out, const vector<Measurement> &results, const Options &options) {
+    out << "{\n";
+    out << "  \"revision\": \"" << escape(AOC_REVISION) << "\",\n";
+    out << "  \"build_type\": \"" << escape(AOC_BUILD_TYPE) << "\",\n";
+    out << "  \"reps\": " << options.reps << ",\n";
+    out << "  \"warmup\": " << options.warmup << ",\n";
+    out << "  \"arena\": " << (options.arena ? "true" : "false") << ",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto &m = results[i];
+        out << (0 == i ? "\n" : ",\n");
+        out << "    {\"day\": \"" << m.day << "\", \"part\": " << m.part << ", \"size\": " << m.size
+            << ", \"answer\": \"" << escape(m.answer) << "\""
+            << ", \"runs\": " << m.nanos.size()
+            << fixed << setprecision(0)
+            << ", \"min_ns\": " << m.percentile(0)
+            << ", \"p50_ns\": " << m.percentile(50)
+            << ", \"p99_ns\": " << m.percentile(99)
+            << ", \"allocations\": " << m.allocations
+            << ", \"allocated_bytes\": " << m.bytes
+            << ", \"peak_rss_kb\": " << m.peakRssKb << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+static void writeHeader(ostream &out) {
+    out << left << setw(9) << "day" << setw(6) << "part" << setw(10) << "size" << setw(18) << "answer" << right
+        << setw(6) << "runs" << setw(12) << "min ms" << setw(12) << "p50 ms" << setw(12) << "p99 ms"
+        << setw(12) << "allocs" << setw(12) << "alloc KB" << setw(10) << "RSS MB" << endl;
+}
+
+static void writeRow(ostream &out, const Measurement &m) {
+    out << left << setw(9) << m.day << setw(6) << m.part << setw(10) << (0 == m.size ? "-" : to_string(m.size)) << setw(18) << m.answer << right
+        << setw(6) << m.nanos.size() << fixed << setprecision(3)
+        << setw(12) << m.percentile(0) * 1e-6 << setw(12) << m.percentile(50) * 1e-6
+        << setw(12) << m.percentile(99) * 1e-6
+        << setw(12) << m.allocations << setw(12) << m.bytes / 1024
+        << setprecision(1) << setw(10) << static_cast<double>(m.peakRssKb) / 1024 << endl;
+}
+
+// Runs write(ostream&) against the named file, or stdout for "-"; an empty name is a no-op
+static bool writeTo(const string &fileName, void (*write)(ostream &)) {
+    if (fileName.empty()) {
+        return true;
+    }
+    if ("-" == fileName) {
+        write(cout);
+        return true;
+    }
+    ofstream out(fileName);
+    if (!out) {
+        cerr << "Cannot open file " << fileName << endl;
+        return false;
+    }
+    write(out);
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        const auto hasValue = i + 1 < argc;
+        if ("--day" == arg && hasValue) {
+            options.days.emplace_back(argv[++i]);
+        } else if ("--reps" == arg && hasValue) {
+            options.reps = max(1, stoi(argv[++i]));
+        } else if ("--warmup" == arg && hasValue) {
+            options.warmup = max(0, stoi(argv[++i]));
+        } else if ("--max-seconds" == arg && hasValue) {
+            options.maxSeconds = stod(argv[++i]);
+        } else if ("--root" == arg && hasValue) {
+            options.root = argv[++i];
+        } else if ("--json" == arg && hasValue) {
+            options.json = argv[++i];
+        } else if ("--counters" == arg && hasValue) {
+            options.counters = argv[++i];
+        } else if ("--trace" == arg && hasValue) {
+            options.trace = argv[++i];
+        } else if ("--size" == arg && hasValue) {
+            options.sizes.push_back(stoull(argv[++i]));
+        } else if ("--seed" == arg && hasValue) {
+            options.seed = stoull(argv[++i]);
+        } else if ("--no-arena" == arg) {
+            options.arena = false;
+        } else {
+            cerr << "Usage: " << argv[0] << " [--day <name>]... [--reps <n>] [--warmup <n>]"
+                 << " [--max-seconds <s>] [--root <dir>] [--json <file>|-] [--counters <file>|-]"
+                 << " [--trace <file>] [--size <n>]... [--seed <n>] [--no-arena]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (!aoc::trace::enabled && !(options.counters.empty() && options.trace.empty())) {
+        cerr << "Built without instrumentation; reconfigure with -DAOC_ENABLE_TRACE=ON" << endl;
+        return EXIT_FAILURE;
+    }
+    aoc::trace::reset();
+    aoc::Arena::enable(options.arena);
+
+    if ("-" != options.json) {
+        writeHeader(cout);
+    }
+    vector<Measurement> results;
+    const auto run = [&](const aoc::Solution &solution, string_view input, size_t size) {
+        for (const int part: {1, 2}) {
+            auto m = measure(solution, part, input, options);
+            if (m.answer.empty()) {
+                continue;  // part not solved for this day
+            }
+            m.size = size;
+            if ("-" != options.json) {
+                writeRow(cout, m);
+            }
+            results.push_back(std::move(m));
+        }
+    };
+    for (const auto &solution: aoc::solutions) {
+        if (!selected(options, solution)) {
+            continue;
+        }
+        if (!options.sizes.empty()) {
+            const auto *generator = aoc::gen::find(solution.name);
+            for (const auto size: options.sizes) {
+                // a day that cannot handle a size is skipped, not the rest of the sweep
+                try {
+                    run(solution, generator->generate(size, options.seed), size);
+                } catch (const exception &e) {
+                    cerr << "Skipped " << solution.name << " of size " << size << " : " << e.what() << endl;
+                }
+            }
+            continue;
+        }
+        const aoc::MappedFile input((options.root / solution.input).string());
+        if (!input) {
+            return EXIT_FAILURE;
+        }
+        try {
+            run(solution, input.view(), 0);
+        } catch (const exception &e) {
+            cerr << "Skipped " << solution.name << " : " << e.what() << endl;
+        }
+    }
+
+    if ("-" == options.json) {
+        writeJson(cout, results, options);
+    } else if (!options.json.empty()) {
+        ofstream out(options.json);
+        if (!out) {
+            cerr << "Cannot open file " << options.json << endl;
+            return EXIT_FAILURE;
+        }
+        writeJson(out, results, options);
+    }
+    if (!writeTo(options.counters, aoc::trace::writeJson) || !writeTo(options.trace, aoc::trace::writeChromeTrace)) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
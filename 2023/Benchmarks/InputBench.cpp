@@ -0,0 +1,211 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// Input layer benchmark: per-day getline readFile vs. the shared memory-mapped readers
+//
+// Usage: InputBench [sizes...] [--dir <path>] [--reps <n>]
+//   sizes accept K/M/G suffixes; the default is 1M 100M 1G
+//   g++ -std=c++20 -O2 -o InputBench InputBench.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../Common/Input.h"
+
+using namespace std;
+
+// The helper every day carried before Common/Input.h
+static bool legacyReadFile(const string &fileName, vector<string> &lines) {
+    ifstream in(fileName);
+    if (!in) {
+        cerr << "Cannot open file " << fileName << endl;
+        return false;
+    }
+
+    auto closeStream = [&in] {
+        in.close();
+    };
+
+    string str;
+    while (getline(in, str)) {
+        lines.push_back(str);
+    }
+
+    closeStream();
+    return true;
+}
+
+static uint64_t parseSize(const string &arg) {
+    uint64_t value = stoull(arg);
+    switch (toupper(arg.back())) {
+        case 'G':
+            value <<= 10;
+            [[fallthrough]];
+        case 'M':
+            value <<= 10;
+            [[fallthrough]];
+        case 'K':
+            value <<= 10;
+            break;
+        default:
+            break;
+    }
+    return value;
+}
+
+// Lines of 1..160 puzzle-like characters, so the line count is realistic for a grid or a list input
+static void generate(const string &fileName, uint64_t bytes) {
+    constexpr string_view alphabet = "0123456789#.|-LJ7F abcdefghijklmnopqrstuvwxyz,:;=";
+    mt19937_64 rng(bytes);
+    uniform_int_distribution<size_t> length(1, 160);
+    uniform_int_distribution<size_t> pick(0, alphabet.size() - 1);
+
+    ofstream out(fileName, ios::binary);
+    string chunk;
+    chunk.reserve(1 << 20);
+    uint64_t written{};
+    while (written < bytes) {
+        const auto n = min<uint64_t>(length(rng), bytes - written - 1);
+        for (size_t i = 0; i < n; ++i) {
+            chunk.push_back(alphabet[pick(rng)]);
+        }
+        chunk.push_back('\n');
+        written += n + 1;
+        if (chunk.size() >= (1 << 20) - 256) {
+            out.write(chunk.data(), static_cast<streamsize>(chunk.size()));
+            chunk.clear();
+        }
+    }
+    out.write(chunk.data(), static_cast<streamsize>(chunk.size()));
+}
+
+struct Result {
+    double seconds{};
+    uint64_t lines{};
+    uint64_t checksum{};
+};
+
+template<typename F>
+static Result measure(F &&readLines, int reps) {
+    Result best{1e30};
+    for (int i = 0; i < reps; ++i) {
+        const auto start = chrono::steady_clock::now();
+        const auto [lines, checksum] = readLines();
+        const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        best.seconds = min(best.seconds, elapsed.count());
+        best.lines = lines;
+        best.checksum = checksum;
+    }
+    return best;
+}
+
+template<typename Lines>
+static pair<uint64_t, uint64_t> summarize(const Lines &lines) {
+    uint64_t checksum{};
+    for (const auto &line: lines) {
+        checksum += line.size() + (line.empty() ? 0 : static_cast<unsigned char>(line.back()));
+    }
+    return {lines.size(), checksum};
+}
+
+int main(int argc, char *argv[]) {
+    vector<uint64_t> sizes;
+    filesystem::path dir = filesystem::temp_directory_path();
+    int reps{3};
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        if ("--dir" == arg && i + 1 < argc) {
+            dir = argv[++i];
+        } else if ("--reps" == arg && i + 1 < argc) {
+            reps = max(1, stoi(argv[++i]));
+        } else {
+            sizes.push_back(parseSize(arg));
+        }
+    }
+    if (sizes.empty()) {
+        sizes = {parseSize("1M"), parseSize("100M"), parseSize("1G")};
+    }
+
+    cout << "Input layer benchmark (best of " << reps << ", warm page cache)" << endl;
+    cout << left << setw(10) << "size" << setw(38) << "reader" << right << setw(12) << "lines"
+         << setw(12) << "ms" << setw(12) << "MB/s" << endl;
+
+    for (const auto bytes: sizes) {
+        const auto fileName = (dir / ("aoc_input_bench_" + to_string(bytes) + ".txt")).string();
+        generate(fileName, bytes);
+        {
+            // warm the page cache so every reader sees the same conditions
+            const aoc::MappedFile warm(fileName);
+            volatile uint64_t touch{};
+            for (size_t i = 0; i < warm.view().size(); i += 4096) {
+                touch = touch + static_cast<unsigned char>(warm.view()[i]);
+            }
+        }
+
+        const auto legacy = measure([&] {
+            vector<string> lines;
+            legacyReadFile(fileName, lines);
+            return summarize(lines);
+        }, reps);
+        const auto copied = measure([&] {
+            vector<string> lines;
+            aoc::readFile(fileName, lines);
+            return summarize(lines);
+        }, reps);
+        const auto viewed = measure([&] {
+            // the mapping outlives the call, so each repetition keeps one more file mapped
+            vector<string_view> lines;
+            aoc::readFile(fileName, lines);
+            return summarize(lines);
+        }, reps);
+        const auto mapped = measure([&] {
+            const aoc::MappedFile file(fileName);
+            return summarize(aoc::splitLines(file.view()));
+        }, reps);
+
+        const auto report = [&](const string &name, const Result &r) {
+            cout << left << setw(10) << to_string(bytes >> 20) + "MB" << setw(38) << name << right
+                 << setw(12) << r.lines << setw(12) << fixed << setprecision(1) << r.seconds * 1e3
+                 << setw(12) << static_cast<double>(bytes) / (1 << 20) / r.seconds;
+            if (r.checksum != legacy.checksum || r.lines != legacy.lines) {
+                cout << "  MISMATCH";
+            }
+            cout << endl;
+        };
+        report("getline readFile (vector<string>)", legacy);
+        report("aoc::readFile (vector<string>)", copied);
+        report("aoc::readFile (vector<string_view>)", viewed);
+        report("MappedFile + splitLines (views)", mapped);
+
+        filesystem::remove(fileName);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// Integer parsing benchmark: istringstream extraction vs. aoc::parseIntegers (scalar and AVX2)
+//
+// Usage: ParseBench [sizes...] [--reps <n>]
+//   sizes accept K/M/G suffixes; the default is 1M 64M
+//   g++ -std=c++20 -O2 -o ParseBench ParseBench.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../Common/Parse.h"
+
+using namespace std;
+
+static uint64_t parseSize(const string &arg) {
+    uint64_t value = stoull(arg);
+    switch (toupper(arg.back())) {
+        case 'G':
+            value <<= 10;
+            [[fallthrough]];
+        case 'M':
+            value <<= 10;
+            [[fallthrough]];
+        case 'K':
+            value <<= 10;
+            break;
+        default:
+            break;
+    }
+    return value;
+}
+
+// "short": Day_9-like lines of 21 small numbers; "long": Day_24-like "x, y, z @ dx, dy, dz"
+static string generate(uint64_t bytes, bool longNumbers) {
+    mt19937_64 rng(bytes + longNumbers);
+    uniform_int_distribution<int> digits(1, longNumbers ? 15 : 3);
+    uniform_int_distribution<int> digit(0, 9);
+    bernoulli_distribution negative(0.3);
+
+    string text;
+    text.reserve(bytes + 64);
+    size_t column{};
+    while (text.size() < bytes) {
+        if (negative(rng)) {
+            text += '-';
+        }
+        text += static_cast<char>('1' + digit(rng) % 9);
+        for (int i = digits(rng) - 1; i > 0; --i) {
+            text += static_cast<char>('0' + digit(rng));
+        }
+        column++;
+        if (longNumbers) {
+            text += 6 == column ? "\n" : 3 == column ? " @ " : ", ";
+        } else {
+            text += 21 == column ? "\n" : " ";
+        }
+        column %= longNumbers ? 6 : 21;
+    }
+    return text;
+}
+
+struct Result {
+    double seconds{};
+    vector<int64_t> values;
+};
+
+// parse() returns the number of values it produced; collect() copies them out untimed
+template<typename F, typename G>
+static Result measure(F &&parse, G &&collect, int reps) {
+    Result best{1e30, {}};
+    for (int i = 0; i < reps; ++i) {
+        const auto start = chrono::steady_clock::now();
+        const auto n = parse();
+        const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        best.seconds = min(best.seconds, elapsed.count());
+        best.values = collect(n);
+    }
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    vector<uint64_t> sizes;
+    int reps{3};
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        if ("--reps" == arg && i + 1 < argc) {
+            reps = max(1, stoi(argv[++i]));
+        } else {
+            sizes.push_back(parseSize(arg));
+        }
+    }
+    if (sizes.empty()) {
+        sizes = {parseSize("1M"), parseSize("64M")};
+    }
+
+    cout << "Integer parsing benchmark (best of " << reps << ")" << endl;
+    cout << left << setw(10) << "size" << setw(8) << "text" << setw(28) << "parser" << right << setw(12)
+         << "numbers" << setw(12) << "ms" << setw(10) << "GB/s" << endl;
+
+    for (const auto bytes: sizes) {
+        for (const bool longNumbers: {false, true}) {
+            const auto text = generate(bytes, longNumbers);
+
+            // The pattern the days used: one stream, ignore the separator after each number
+            vector<int64_t> streamed;
+            const auto stream = measure([&] {
+                streamed.clear();
+                istringstream iss{text};
+                int64_t x;
+                while (iss >> x) {
+                    streamed.push_back(x);
+                    iss.ignore(1);
+                    if (iss.peek() == '@') {
+                        iss.ignore(1);
+                    }
+                }
+                return streamed.size();
+            }, [&](size_t) { return streamed; }, reps);
+
+            // The parsers write into a caller-provided buffer, allocated and faulted in up front
+            vector<int64_t> buffer(stream.values.size());
+            const auto collect = [&](size_t n) {
+                return vector<int64_t>(buffer.begin(), buffer.begin() + static_cast<ptrdiff_t>(n));
+            };
+            const auto scalar = measure([&] { return aoc::detail::parseScalar(text, span(buffer)); }, collect, reps);
+
+            const auto report = [&](const string &name, const Result &r) {
+                cout << left << setw(10) << to_string(bytes >> 20) + "MB" << setw(8)
+                     << (longNumbers ? "long" : "short") << setw(28) << name << right << setw(12) << r.values.size()
+                     << setw(12) << fixed << setprecision(1) << r.seconds * 1e3 << setw(10) << setprecision(3)
+                     << static_cast<double>(text.size()) / 1e9 / r.seconds;
+                if (r.values != stream.values) {
+                    cout << "  MISMATCH";
+                }
+                cout << endl;
+            };
+            report("istringstream >> int64_t", stream);
+            report("parseIntegers (scalar)", scalar);
+#ifdef AOC_PARSE_AVX2
+            if (aoc::detail::hasAvx2()) {
+                const auto avx2 = measure([&] { return aoc::detail::parseAvx2(text, span(buffer)); }, collect, reps);
+                report("parseIntegers (AVX2)", avx2);
+            }
+#endif
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// Per-solve arena: a std::pmr memory resource whose memory all goes back in one shot
+
+#ifndef AOC_COMMON_ARENA_H
+#define AOC_COMMON_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include "Trace.h"
+
+namespace aoc {
+
+/*
+ * Monotonic bump allocator for the temporaries of one solve. Containers take it as their
+ * std::pmr memory resource; deallocation does nothing and the chunks are handed back to the heap
+ * when the arena goes out of scope, so it has to be declared before, and outlive, everything
+ * built on it. Solves that free and reallocate as they go put a
+ * std::pmr::unsynchronized_pool_resource on top, which recycles the freed blocks and takes its
+ * chunks from the arena.
+ *
+ * An arena is not thread-safe; every solve creates its own. With tracing compiled in, the
+ * number of allocations it served and of heap chunks it took are added to "arena.allocations"
+ * and "arena.chunks".
+ */
+class Arena : public std::pmr::memory_resource {
+public:
+    explicit Arena(std::size_t initialSize = 64 * 1024) : forward{!enabled()}, monotonic{initialSize, &heap} {
+    }
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    ~Arena() override {
+        AOC_TRACE_ADD("arena.allocations", served);
+        AOC_TRACE_ADD("arena.chunks", heap.chunks);
+    }
+
+    // allocations served, and how many heap allocations they took
+    [[nodiscard]] std::uint64_t allocations() const {
+        return served;
+    }
+
+    [[nodiscard]] std::uint64_t chunks() const {
+        return heap.chunks;
+    }
+
+    // Turned off, arenas created afterwards pass every call straight to the heap, so benchmarks
+    // can compare both in one process
+    static void enable(bool on) {
+        switchedOn().store(on, std::memory_order_relaxed);
+    }
+
+    static bool enabled() {
+        return switchedOn().load(std::memory_order_relaxed);
+    }
+
+private:
+    // The heap, counting what it hands out
+    struct Heap : std::pmr::memory_resource {
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+            ++chunks;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        [[nodiscard]] bool do_is_equal(const memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+
+        std::uint64_t chunks{};
+    };
+
+    static std::atomic<bool> &switchedOn() {
+        static std::atomic<bool> on{true};
+        return on;
+    }
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++served;
+        return forward ? heap.allocate(bytes, alignment) : monotonic.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        if (forward) {
+            heap.deallocate(p, bytes, alignment);
+        }
+    }
+
+    [[nodiscard]] bool do_is_equal(const memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    bool forward;
+    std::uint64_t served{};
+    Heap heap;
+    std::pmr::monotonic_buffer_resource monotonic;
+};
+
+}  // namespace aoc
+
+#endif  // AOC_COMMON_ARENA_H
@@ -0,0 +1,144 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// On-disk cache of answers, addressed by the content of the input and of the solver binary
+
+#ifndef AOC_COMMON_CACHE_H
+#define AOC_COMMON_CACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include "Input.h"
+#include "Solver.h"
+
+namespace aoc {
+
+// 64-bit FNV-1a; inputs and binaries are small enough that its speed does not matter
+inline std::uint64_t hashBytes(std::string_view bytes, std::uint64_t hash = 0xcbf29ce484222325ULL) {
+    for (const auto c: bytes) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+inline std::string toHex(std::uint64_t value) {
+    constexpr std::string_view digits = "0123456789abcdef";
+    std::string hex(16, '0');
+    for (auto it = hex.rbegin(); it != hex.rend(); ++it, value >>= 4) {
+        *it = digits[value & 0xf];
+    }
+    return hex;
+}
+
+/*
+ * One file per answer, at <directory>/<build>/<day>-<part>-<input hash>. The build is a hash of
+ * the running executable, so rebuilding the solvers starts from an empty cache without anything
+ * having to be deleted; old builds can be removed by hand. Every error is swallowed: the cache
+ * can only ever turn a computed answer into a cached one, never fail a run.
+ */
+class ResultCache {
+public:
+    // A default constructed cache is disabled
+    ResultCache() = default;
+
+    ResultCache(const std::filesystem::path &directory, std::string_view build)
+            : directory{directory / std::string(build)} {
+    }
+
+    explicit operator bool() const {
+        return !directory.empty();
+    }
+
+    [[nodiscard]] std::filesystem::path entry(std::string_view day, int part, std::string_view input) const {
+        return directory / (std::string(day) + '-' + std::to_string(part) + '-' + toHex(hashBytes(input)));
+    }
+
+    [[nodiscard]] std::optional<Answer> load(const std::filesystem::path &entry) const {
+        if (!*this) {
+            return std::nullopt;
+        }
+        std::ifstream in(entry, std::ios::binary);
+        if (!in) {
+            return std::nullopt;
+        }
+        return Answer(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    // Written next to the entry and renamed over it, so readers never see half an answer
+    void store(const std::filesystem::path &entry, const Answer &answer) const {
+        if (!*this) {
+            return;
+        }
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        std::ostringstream suffix;
+#ifdef _WIN32
+        suffix << ".tmp" << GetCurrentProcessId() << '-' << std::this_thread::get_id();
+#else
+        suffix << ".tmp" << getpid() << '-' << std::this_thread::get_id();
+#endif
+        auto temporary = entry;
+        temporary += suffix.str();
+        {
+            std::ofstream out(temporary, std::ios::binary);
+            if (!out || !(out << answer) || !out.flush()) {
+                out.close();
+                std::filesystem::remove(temporary, error);
+                return;
+            }
+        }
+        std::filesystem::rename(temporary, entry, error);
+        if (error) {
+            std::filesystem::remove(temporary, error);
+        }
+    }
+
+    // Hash of the bytes of the running executable, or empty when it cannot be read
+    static std::string buildIdentity(const char *argv0) {
+        std::error_code error;
+        auto executable = std::filesystem::read_symlink("/proc/self/exe", error);
+        if (error) {
+            executable = argv0;
+        }
+        const MappedFile binary(executable.string());
+        if (!binary) {
+            return {};
+        }
+        return toHex(hashBytes(binary.view()));
+    }
+
+private:
+    std::filesystem::path directory;
+};
+
+}  // namespace aoc
+
+#endif  // AOC_COMMON_CACHE_H
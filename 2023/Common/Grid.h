@@ -0,0 +1,201 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// Dense 2-D grid with a sentinel border ring, addressed by flat index
+
+#ifndef AOC_COMMON_GRID_H
+#define AOC_COMMON_GRID_H
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <vector>
+#include "Input.h"
+
+namespace aoc {
+
+/*
+ * All rows share one allocation of (rows + 2) x (cols + 2) cells. The outer ring holds a
+ * caller-chosen border value, so a neighbour of any interior cell is always addressable
+ * and inner loops test the cell value instead of four edge conditions.
+ * Directions follow the repo convention: 0 = E, 1 = S, 2 = W, 3 = N.
+ */
+template<class T>
+class Grid {
+public:
+    // Flat indices of the interior cells, row by row
+    class CellIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const size_t *;
+        using reference = size_t;
+
+        CellIterator() = default;
+
+        CellIterator(size_t index, size_t cols) : index{index}, cols{cols} {
+        }
+
+        size_t operator*() const {
+            return index;
+        }
+
+        CellIterator &operator++() {
+            if (++col == cols) {
+                col = 0;
+                index += 3;  // skip the east border, the west border of the next row, then step in
+            } else {
+                ++index;
+            }
+            return *this;
+        }
+
+        CellIterator operator++(int) {
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+
+        bool operator==(const CellIterator &other) const {
+            return index == other.index;
+        }
+
+    private:
+        size_t index{};
+        size_t col{};
+        size_t cols{};
+    };
+
+    struct Cells {
+        CellIterator first;
+        CellIterator last;
+
+        [[nodiscard]] CellIterator begin() const {
+            return first;
+        }
+
+        [[nodiscard]] CellIterator end() const {
+            return last;
+        }
+    };
+
+    Grid() = default;
+
+    Grid(size_t rows, size_t cols, const T &fill, const T &border)
+            : rowCount{0 == cols ? 0 : rows}, colCount{0 == rows ? 0 : cols}, stride{colCount + 2},
+              cells((rowCount + 2) * stride, border) {
+        for (const auto i: interior()) {
+            cells[i] = fill;
+        }
+    }
+
+    // One row per input line, each character mapped through convert(char) -> T
+    template<class F>
+    static Grid parse(std::string_view input, const T &border, F &&convert) {
+        const auto lines = splitLines(input);
+        const auto rows = lines.size() - (!lines.empty() && lines.back().empty() ? 1 : 0);
+        Grid grid(rows, 0 == rows ? 0 : lines[0].size(), border, border);
+        for (size_t r = 0; r < grid.rows(); ++r) {
+            for (size_t c = 0; c < grid.cols() && c < lines[r].size(); ++c) {
+                grid.at(r, c) = convert(lines[r][c]);
+            }
+        }
+        return grid;
+    }
+
+    [[nodiscard]] size_t rows() const {
+        return rowCount;
+    }
+
+    [[nodiscard]] size_t cols() const {
+        return colCount;
+    }
+
+    // Number of cells including the border ring
+    [[nodiscard]] size_t size() const {
+        return cells.size();
+    }
+
+    [[nodiscard]] size_t index(size_t row, size_t col) const {
+        return (row + 1) * stride + col + 1;
+    }
+
+    [[nodiscard]] size_t row(size_t index) const {
+        return index / stride - 1;
+    }
+
+    [[nodiscard]] size_t col(size_t index) const {
+        return index % stride - 1;
+    }
+
+    // Flat-index step for each direction
+    [[nodiscard]] std::array<std::ptrdiff_t, 4> offsets() const {
+        const auto s = static_cast<std::ptrdiff_t>(stride);
+        return {1, s, -1, -s};
+    }
+
+    [[nodiscard]] bool isBorder(size_t index) const {
+        const auto c = index % stride;
+        return index < stride || index >= (rowCount + 1) * stride || 0 == c || stride - 1 == c;
+    }
+
+    [[nodiscard]] Cells interior() const {
+        return {CellIterator(index(0, 0), colCount), CellIterator(index(rowCount, 0), colCount)};
+    }
+
+    T &operator[](size_t index) {
+        return cells[index];
+    }
+
+    const T &operator[](size_t index) const {
+        return cells[index];
+    }
+
+    T &at(size_t row, size_t col) {
+        return cells[index(row, col)];
+    }
+
+    const T &at(size_t row, size_t col) const {
+        return cells[index(row, col)];
+    }
+
+    T *data() {
+        return cells.data();
+    }
+
+    const T *data() const {
+        return cells.data();
+    }
+
+private:
+    size_t rowCount{};
+    size_t colCount{};
+    size_t stride{2};
+    std::vector<T> cells;
+};
+
+}  // namespace aoc
+
+#endif  // AOC_COMMON_GRID_H
@@ -0,0 +1,268 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// Shared input layer: memory-mapped puzzle files handed out as string_view lines
+
+#ifndef AOC_COMMON_INPUT_H
+#define AOC_COMMON_INPUT_H
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace aoc {
+
+/*
+ * Read-only view over the bytes of a whole file. Regular files are memory mapped;
+ * anything that cannot be mapped (empty files, pipes) is read into an owned buffer.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::string &fileName) {
+        open(fileName);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept {
+        swap(other);
+    }
+
+    MappedFile &operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            close();
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        close();
+    }
+
+    bool open(const std::string &fileName) {
+        close();
+        if (!map(fileName)) {
+            std::ifstream in(fileName, std::ios::binary);
+            if (!in) {
+                std::cerr << "Cannot open file " << fileName << std::endl;
+                return false;
+            }
+            buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            data = buffer.data();
+            size = buffer.size();
+        }
+        opened = true;
+        return true;
+    }
+
+    void close() {
+        if (mapped) {
+#ifdef _WIN32
+            UnmapViewOfFile(data);
+#else
+            munmap(const_cast<char *>(data), size);
+#endif
+        }
+        data = nullptr;
+        size = 0;
+        mapped = false;
+        opened = false;
+        buffer.clear();
+    }
+
+    [[nodiscard]] bool isOpen() const {
+        return opened;
+    }
+
+    explicit operator bool() const {
+        return opened;
+    }
+
+    [[nodiscard]] std::string_view view() const {
+        return {data, size};
+    }
+
+private:
+    bool map(const std::string &fileName) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (INVALID_HANDLE_VALUE == file) {
+            return false;
+        }
+        LARGE_INTEGER length{};
+        HANDLE mapping = nullptr;
+        if (GetFileSizeEx(file, &length) && length.QuadPart > 0) {
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        }
+        if (nullptr != mapping) {
+            data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        if (nullptr == data) {
+            return false;
+        }
+        size = static_cast<size_t>(length.QuadPart);
+#else
+        const int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st{};
+        void *p = MAP_FAILED;
+        if (0 == fstat(fd, &st) && S_ISREG(st.st_mode) && st.st_size > 0) {
+            int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+            flags |= MAP_POPULATE;  // puzzles are read front to back, so fault the pages in up front
+#endif
+            p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, flags, fd, 0);
+        }
+        ::close(fd);
+        if (MAP_FAILED == p) {
+            return false;
+        }
+        madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+        data = static_cast<const char *>(p);
+        size = static_cast<size_t>(st.st_size);
+#endif
+        mapped = true;
+        return true;
+    }
+
+    void swap(MappedFile &other) noexcept {
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+        std::swap(mapped, other.mapped);
+        std::swap(opened, other.opened);
+        buffer.swap(other.buffer);
+        // a small owned buffer lives inside the string object, so re-point at it after the swap
+        if (opened && !mapped) {
+            data = buffer.data();
+        }
+        if (other.opened && !other.mapped) {
+            other.data = other.buffer.data();
+        }
+    }
+
+    const char *data{};
+    size_t size{};
+    bool mapped{false};
+    bool opened{false};
+    std::string buffer;
+};
+
+/*
+ * Calls f once per line of text, getline style: a trailing newline does not
+ * produce an empty last line, and a '\r' before the '\n' is dropped.
+ */
+template<typename F>
+void forEachLine(std::string_view text, F &&f) {
+    size_t pos{};
+    while (pos < text.size()) {
+        const auto *nl = static_cast<const char *>(std::memchr(text.data() + pos, '\n', text.size() - pos));
+        const size_t end = nullptr == nl ? text.size() : static_cast<size_t>(nl - text.data());
+        auto line = text.substr(pos, end - pos);
+        if (!line.empty() && '\r' == line.back()) {
+            line.remove_suffix(1);
+        }
+        f(line);
+        pos = end + 1;
+    }
+}
+
+/*
+ * Splits text into lines that point back into it; nothing is copied.
+ */
+inline std::vector<std::string_view> splitLines(std::string_view text) {
+    std::vector<std::string_view> lines;
+    lines.reserve(static_cast<size_t>(std::count(text.begin(), text.end(), '\n')) + 1);
+    forEachLine(text, [&lines](std::string_view line) {
+        lines.push_back(line);
+    });
+    return lines;
+}
+
+/*
+ * Drop-in replacement for the per-day readFile helpers. The views point into a
+ * mapping that is kept alive for the rest of the process.
+ */
+inline bool readFile(const std::string &fileName, std::vector<std::string_view> &lines) {
+    static std::mutex lock;
+    static std::vector<std::unique_ptr<MappedFile> > retained;
+
+    auto file = std::make_unique<MappedFile>(fileName);
+    if (!*file) {
+        return false;
+    }
+    forEachLine(file->view(), [&lines](std::string_view line) {
+        lines.push_back(line);
+    });
+
+    const std::lock_guard<std::mutex> guard(lock);
+    retained.push_back(std::move(file));
+    return true;
+}
+
+/*
+ * Same as above for callers that need to own (and modify) their lines. The file
+ * is still mapped, so each line costs exactly one allocation and no stream work.
+ */
+inline bool readFile(const std::string &fileName, std::vector<std::string> &lines) {
+    const MappedFile file(fileName);
+    if (!file) {
+        return false;
+    }
+    forEachLine(file.view(), [&lines](std::string_view line) {
+        lines.emplace_back(line);
+    });
+    return true;
+}
+
+}  // namespace aoc
+
+#endif  // AOC_COMMON_INPUT_H
@@ -0,0 +1,187 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// Integer extraction from puzzle text without streams or allocation
+
+#ifndef AOC_COMMON_PARSE_H
+#define AOC_COMMON_PARSE_H
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define AOC_PARSE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace aoc {
+
+namespace detail {
+
+// Value of the len (<= 8) ASCII digits at p, reading 8 bytes: p + 8 must be readable
+inline uint64_t swarDigits(const char *p, size_t len) {
+    uint64_t chunk;
+    std::memcpy(&chunk, p, sizeof(chunk));
+    if constexpr (std::endian::native == std::endian::big) {
+        chunk = __builtin_bswap64(chunk);
+    }
+    chunk = (chunk - 0x3030303030303030ULL) << (8 * (8 - len));  // missing digits become leading zeros
+    chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FFULL;
+    chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFFULL;
+    return (chunk * 10000 + (chunk >> 32)) & 0xFFFFFFFFULL;
+}
+
+inline uint64_t digits(const char *p, size_t len, const char *end) {
+    if (len <= 16 && p + 8 + (len > 8 ? len - 8 : 0) <= end) {
+        if (len <= 8) {
+            return swarDigits(p, len);
+        }
+        return swarDigits(p, len - 8) * 100000000ULL + swarDigits(p + len - 8, 8);
+    }
+    uint64_t value{};
+    for (size_t i = 0; i < len; ++i) {
+        value = value * 10 + static_cast<uint64_t>(p[i] - '0');
+    }
+    return value;
+}
+
+inline bool isDigit(char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+// A '-' right before the digits at begin negates signed types
+template<class T>
+inline T withSign(std::string_view text, size_t begin, uint64_t value) {
+    if constexpr (std::is_signed_v<T>) {
+        return begin > 0 && '-' == text[begin - 1] ? -static_cast<T>(value) : static_cast<T>(value);
+    } else {
+        return static_cast<T>(value);
+    }
+}
+
+// Once out is full the rest of the integers are only counted
+template<class T>
+size_t parseScalar(std::string_view text, std::span<T> out, size_t pos = 0, size_t count = 0) {
+    while (pos < text.size()) {
+        if (!isDigit(text[pos])) {
+            ++pos;
+            continue;
+        }
+        const auto begin = pos;
+        uint64_t value{};
+        do {
+            value = value * 10 + static_cast<uint64_t>(text[pos++] - '0');
+        } while (pos < text.size() && isDigit(text[pos]));
+        if (count < out.size()) {
+            out[count] = withSign<T>(text, begin, value);
+        }
+        ++count;
+    }
+    return count;
+}
+
+#ifdef AOC_PARSE_AVX2
+
+// Classifies 32 bytes at a time into masks of the first and last digit of every run, so
+// separators cost nothing and each number is converted with at most two SWAR steps
+template<class T>
+__attribute__((target("avx2,bmi,bmi2,popcnt"))) size_t parseAvx2(std::string_view text, std::span<T> out) {
+    const auto *p = text.data();
+    const auto *end = p + text.size();
+    const auto lo = _mm256_set1_epi8('0' - 1);
+    const auto hi = _mm256_set1_epi8('9' + 1);
+    size_t pos{};
+    size_t count{};
+    while (pos + 32 <= text.size()) {
+        const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + pos));
+        const auto isDigitMask = _mm256_and_si256(_mm256_cmpgt_epi8(bytes, lo), _mm256_cmpgt_epi8(hi, bytes));
+        const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(isDigitMask));
+        auto starts = mask & ~(mask << 1);
+        auto lasts = mask & ~(mask >> 1);
+        auto next = pos + 32;
+        if (mask >> 31) {  // the last run may continue past this block: restart from it
+            const auto open = 31 - std::countl_zero(starts);
+            if (0 == open) {  // 32 digits or more, never a puzzle value: convert it on its own
+                if (count == out.size()) {  // full: the scalar loop counts the rest
+                    break;
+                }
+                const auto begin = pos;
+                uint64_t value{};
+                while (pos < text.size() && isDigit(p[pos])) {
+                    value = value * 10 + static_cast<uint64_t>(p[pos++] - '0');
+                }
+                out[count++] = withSign<T>(text, begin, value);
+                continue;
+            }
+            next = pos + static_cast<size_t>(open);
+            starts ^= 1U << open;
+            lasts ^= 1U << 31;
+        }
+        if (count + static_cast<size_t>(std::popcount(starts)) > out.size()) {  // the scalar loop fills the rest
+            break;
+        }
+        while (0 != starts) {
+            const auto first = static_cast<size_t>(std::countr_zero(starts));
+            const auto last = static_cast<size_t>(std::countr_zero(lasts));
+            out[count++] = withSign<T>(text, pos + first, digits(p + pos + first, last - first + 1, end));
+            starts &= starts - 1;
+            lasts &= lasts - 1;
+        }
+        pos = next;
+    }
+    return parseScalar(text, out, pos, count);
+}
+
+inline bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#endif  // AOC_PARSE_AVX2
+
+}  // namespace detail
+
+/*
+ * Writes the integers found in text, in order, into out and returns how many text holds. Only
+ * the first out.size() are written, so a result over out.size() means out was too small. Any
+ * non-digit separates numbers; for signed T a '-' directly in front of the digits makes the
+ * value negative. Values are not range checked.
+ */
+template<class T, size_t Extent>
+size_t parseIntegers(std::string_view text, std::span<T, Extent> out) {
+    static_assert(std::is_integral_v<T>);
+#ifdef AOC_PARSE_AVX2
+    if (detail::hasAvx2()) {
+        return detail::parseAvx2(text, std::span<T>(out));
+    }
+#endif
+    return detail::parseScalar(text, std::span<T>(out));
+}
+
+}  // namespace aoc
+
+#endif  // AOC_COMMON_PARSE_H
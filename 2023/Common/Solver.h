@@ -0,0 +1,116 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// Callable entry points of every day, shared by the benchmark harness and the runner
+
+#ifndef AOC_COMMON_SOLVER_H
+#define AOC_COMMON_SOLVER_H
+
+#include <array>
+#include <string>
+#include <string_view>
+
+namespace aoc {
+
+// Answers are kept as text: a few days report something other than a single integer
+using Answer = std::string;
+using SolveFn = Answer (*)(std::string_view input);
+
+struct Solution {
+    std::string_view name;   // directory of the day, e.g. "Day_9"
+    std::string_view input;  // puzzle input, relative to the 2023 directory
+    SolveFn part1;
+    SolveFn part2;
+};
+
+}  // namespace aoc
+
+#define AOC_DECLARE_DAY(ns)                                  \
+    namespace ns {                                           \
+    aoc::Answer solvePart1(std::string_view input);          \
+    aoc::Answer solvePart2(std::string_view input);          \
+    }
+
+AOC_DECLARE_DAY(day1)
+AOC_DECLARE_DAY(day2)
+AOC_DECLARE_DAY(day3)
+AOC_DECLARE_DAY(day4)
+AOC_DECLARE_DAY(day5)
+AOC_DECLARE_DAY(day6)
+AOC_DECLARE_DAY(day7)
+AOC_DECLARE_DAY(day8)
+AOC_DECLARE_DAY(day9)
+AOC_DECLARE_DAY(day10)
+AOC_DECLARE_DAY(day11)
+AOC_DECLARE_DAY(day12)
+AOC_DECLARE_DAY(day13)
+AOC_DECLARE_DAY(day14)
+AOC_DECLARE_DAY(day15)
+AOC_DECLARE_DAY(day16)
+AOC_DECLARE_DAY(day17)
+AOC_DECLARE_DAY(day18)
+AOC_DECLARE_DAY(day19)
+AOC_DECLARE_DAY(day20)
+AOC_DECLARE_DAY(day21)
+AOC_DECLARE_DAY(day22)
+AOC_DECLARE_DAY(day23)
+AOC_DECLARE_DAY(day23b)
+AOC_DECLARE_DAY(day24)
+AOC_DECLARE_DAY(day25)
+
+#undef AOC_DECLARE_DAY
+
+namespace aoc {
+
+inline constexpr std::array<Solution, 26> solutions{{
+        {"Day_1", "Day_1/input1.txt", day1::solvePart1, day1::solvePart2},
+        {"Day_2", "Day_2/input1.txt", day2::solvePart1, day2::solvePart2},
+        {"Day_3", "Day_3/input.txt", day3::solvePart1, day3::solvePart2},
+        {"Day_4", "Day_4/input.txt", day4::solvePart1, day4::solvePart2},
+        {"Day_5", "Day_5/input.txt", day5::solvePart1, day5::solvePart2},
+        {"Day_6", "Day_6/input.txt", day6::solvePart1, day6::solvePart2},
+        {"Day_7", "Day_7/input.txt", day7::solvePart1, day7::solvePart2},
+        {"Day_8", "Day_8/input2.txt", day8::solvePart1, day8::solvePart2},
+        {"Day_9", "Day_9/input.txt", day9::solvePart1, day9::solvePart2},
+        {"Day_10", "Day_10/input.txt", day10::solvePart1, day10::solvePart2},
+        {"Day_11", "Day_11/input.txt", day11::solvePart1, day11::solvePart2},
+        {"Day_12", "Day_12/input.txt", day12::solvePart1, day12::solvePart2},
+        {"Day_13", "Day_13/sample.txt", day13::solvePart1, day13::solvePart2},  // the puzzle input is sample.txt
+        {"Day_14", "Day_14/input.txt", day14::solvePart1, day14::solvePart2},
+        {"Day_15", "Day_15/input.txt", day15::solvePart1, day15::solvePart2},
+        {"Day_16", "Day_16/input.txt", day16::solvePart1, day16::solvePart2},
+        {"Day_17", "Day_17/input.txt", day17::solvePart1, day17::solvePart2},
+        {"Day_18", "Day_18/input.txt", day18::solvePart1, day18::solvePart2},
+        {"Day_19", "Day_19/input.txt", day19::solvePart1, day19::solvePart2},
+        {"Day_20", "Day_20/input.txt", day20::solvePart1, day20::solvePart2},
+        {"Day_21", "Day_21/input.txt", day21::solvePart1, day21::solvePart2},
+        {"Day_22", "Day_22/input.txt", day22::solvePart1, day22::solvePart2},
+        {"Day_23", "Day_23/input.txt", day23::solvePart1, day23::solvePart2},
+        {"Day_23B", "Day_23B/input.txt", day23b::solvePart1, day23b::solvePart2},
+        {"Day_24", "Day_24/input.txt", day24::solvePart1, day24::solvePart2},
+        {"Day_25", "Day_25/input.txt", day25::solvePart1, day25::solvePart2},
+}};
+
+}  // namespace aoc
+
+#endif  // AOC_COMMON_SOLVER_H
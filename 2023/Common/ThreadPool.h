@@ -0,0 +1,226 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// Work-stealing thread pool shared by the runner and the multi-threaded solvers
+
+#ifndef AOC_COMMON_THREADPOOL_H
+#define AOC_COMMON_THREADPOOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace aoc {
+
+/*
+ * Each worker owns a deque: tasks submitted from inside the pool go to the back of the
+ * submitting worker's deque and are popped LIFO, which keeps nested work cache-warm.
+ * Tasks submitted from outside go through a shared FIFO, so callers control the order
+ * in which top-level jobs start. An idle worker steals from the front of its peers.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned count = std::thread::hardware_concurrency()) {
+        count = std::max(1U, count);
+        for (unsigned i = 0; i < count; ++i) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+        for (unsigned i = 0; i < count; ++i) {
+            threads.emplace_back([this, i] { run(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Finishes every queued task before joining the workers
+    ~ThreadPool() {
+        {
+            std::lock_guard guard(sleepLock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &thread: threads) {
+            thread.join();
+        }
+    }
+
+    [[nodiscard]] size_t size() const {
+        return workers.size();
+    }
+
+    template<class F>
+    auto submit(F &&f) -> std::future<std::invoke_result_t<std::decay_t<F> > > {
+        using Result = std::invoke_result_t<std::decay_t<F> >;
+        auto task = std::make_shared<std::packaged_task<Result()> >(std::forward<F>(f));
+        auto future = task->get_future();
+        push([task] { (*task)(); });
+        return future;
+    }
+
+    /*
+     * Calls f(i) for every i in [0, count) on the pool and returns once all calls are done.
+     * The calling thread claims indices as well, so it only ever waits on calls that are
+     * already running: safe to use from inside a pool task, where blocking on a queued
+     * task could deadlock.
+     */
+    template<class F>
+    void parallelFor(size_t count, F &&f) {
+        if (0 == count) {
+            return;
+        }
+        struct Progress {
+            std::atomic<size_t> next{0};
+            size_t done{0};
+            std::mutex lock;
+            std::condition_variable finished;
+        };
+        auto progress = std::make_shared<Progress>();
+        // helpers that start after every index is claimed return without touching f
+        const auto work = [progress, count, &f] {
+            size_t ran = 0;
+            for (auto i = progress->next.fetch_add(1); i < count; i = progress->next.fetch_add(1)) {
+                f(i);
+                ++ran;
+            }
+            if (0 != ran) {
+                std::lock_guard guard(progress->lock);
+                progress->done += ran;
+                if (count == progress->done) {
+                    progress->finished.notify_all();
+                }
+            }
+        };
+        const auto helpers = std::min(count, workers.size() + 1) - 1;
+        for (size_t i = 0; i < helpers; ++i) {
+            push(work);
+        }
+        work();
+        std::unique_lock guard(progress->lock);
+        progress->finished.wait(guard, [&progress, count] { return count == progress->done; });
+    }
+
+    // Process-wide pool sized to the hardware
+    static ThreadPool &global() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+private:
+    using Task = std::function<void()>;
+
+    struct Worker {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    void push(Task task) {
+        if (this == currentPool) {
+            auto &worker = *workers[currentIndex];
+            std::lock_guard guard(worker.lock);
+            worker.tasks.push_back(std::move(task));
+        } else {
+            std::lock_guard guard(injectedLock);
+            injected.push_back(std::move(task));
+        }
+        {
+            std::lock_guard guard(sleepLock);
+            ++pending;
+        }
+        wake.notify_one();
+    }
+
+    bool pop(size_t self, Task &task) {
+        {
+            auto &worker = *workers[self];
+            std::lock_guard guard(worker.lock);
+            if (!worker.tasks.empty()) {
+                task = std::move(worker.tasks.back());
+                worker.tasks.pop_back();
+                return true;
+            }
+        }
+        {
+            std::lock_guard guard(injectedLock);
+            if (!injected.empty()) {
+                task = std::move(injected.front());
+                injected.pop_front();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < workers.size(); ++i) {
+            auto &victim = *workers[(self + i) % workers.size()];
+            std::lock_guard guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(size_t self) {
+        currentPool = this;
+        currentIndex = self;
+        Task task;
+        while (true) {
+            if (pop(self, task)) {
+                pending.fetch_sub(1, std::memory_order_relaxed);
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock guard(sleepLock);
+            wake.wait(guard, [this] { return stopping || pending.load(std::memory_order_relaxed) > 0; });
+            if (stopping && 0 == pending.load(std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker> > workers;
+    std::vector<std::thread> threads;
+    std::mutex injectedLock;
+    std::deque<Task> injected;
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    std::atomic<size_t> pending{0};  // queued but not yet started; only incremented under sleepLock
+    bool stopping{false};
+
+    static inline thread_local ThreadPool *currentPool{nullptr};
+    static inline thread_local size_t currentIndex{0};
+};
+
+}  // namespace aoc
+
+#endif  // AOC_COMMON_THREADPOOL_H
@@ -0,0 +1,306 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// Hot-path instrumentation: named counters, histograms and scoped spans.
+//
+// Everything is compiled out unless AOC_TRACE is defined (cmake -DAOC_ENABLE_TRACE=ON);
+// the macros then expand to nothing and their arguments are not evaluated.
+//
+//   AOC_TRACE_COUNT("day17.push");              // add 1 to a counter
+//   AOC_TRACE_ADD("day16.steps", n);            // add n to a counter
+//   AOC_TRACE_HISTOGRAM("day17.queue", q.size()); // record a value in log2 buckets
+//   AOC_TRACE_SPAN("day17.dijkstra");           // time the enclosing scope
+//
+// Results are exported as JSON (aoc::trace::writeJson) or as a Chrome trace
+// (aoc::trace::writeChromeTrace), which chrome://tracing and Perfetto open directly.
+
+#ifndef AOC_COMMON_TRACE_H
+#define AOC_COMMON_TRACE_H
+
+#ifdef AOC_TRACE
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aoc::trace {
+
+inline constexpr bool enabled = true;
+
+using Clock = std::chrono::steady_clock;
+
+struct Histogram {
+    std::array<std::atomic<uint64_t>, 65> buckets{};  // bucket b holds values in [2^(b-1), 2^b)
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+
+    void record(uint64_t value) {
+        buckets[std::bit_width(value)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+        auto seen = max.load(std::memory_order_relaxed);
+        while (value > seen && !max.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+        }
+    }
+};
+
+struct SpanEvent {
+    const char *name;
+    size_t thread;
+    Clock::time_point begin;
+    Clock::time_point end;
+};
+
+/*
+ * Process-wide store. Counters and histograms are created once per call site (the macros
+ * cache the reference in a function-local static) and never move, so updating them is a
+ * single relaxed atomic operation.
+ */
+class Registry {
+public:
+    static Registry &instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    std::atomic<uint64_t> &counter(const char *name) {
+        std::lock_guard guard(lock);
+        return counters[name];
+    }
+
+    Histogram &histogram(const char *name) {
+        std::lock_guard guard(lock);
+        return histograms[name];
+    }
+
+    void addSpan(const SpanEvent &span) {
+        std::lock_guard guard(lock);
+        spans.push_back(span);
+    }
+
+    // Zero all values; call sites keep their cached references
+    void reset() {
+        std::lock_guard guard(lock);
+        for (auto &[name, value]: counters) {
+            value = 0;
+        }
+        for (auto &[name, h]: histograms) {
+            for (auto &bucket: h.buckets) {
+                bucket = 0;
+            }
+            h.count = 0;
+            h.sum = 0;
+            h.max = 0;
+        }
+        spans.clear();
+        origin = Clock::now();
+    }
+
+    void writeJson(std::ostream &out) {
+        std::lock_guard guard(lock);
+        const FixedFormat format(out);
+        out << "{\n  \"counters\": {";
+        const char *sep = "\n";
+        for (const auto &[name, value]: counters) {
+            out << sep << "    \"" << name << "\": " << value.load();
+            sep = ",\n";
+        }
+        out << "\n  },\n  \"histograms\": {";
+        sep = "\n";
+        for (const auto &[name, h]: histograms) {
+            out << sep << "    \"" << name << "\": {\"count\": " << h.count.load() << ", \"sum\": " << h.sum.load()
+                << ", \"max\": " << h.max.load() << ", \"log2_buckets\": [";
+            const auto last = lastBucket(h);
+            for (size_t b = 0; b <= last; ++b) {
+                out << (0 == b ? "" : ", ") << h.buckets[b].load();
+            }
+            out << "]}";
+            sep = ",\n";
+        }
+        out << "\n  },\n  \"spans\": {";
+        sep = "\n";
+        for (const auto &[name, total]: spanTotals()) {
+            out << sep << "    \"" << name << "\": {\"count\": " << total.first << ", \"total_us\": "
+                << total.second << "}";
+            sep = ",\n";
+        }
+        out << "\n  }\n}\n";
+    }
+
+    void writeChromeTrace(std::ostream &out) {
+        std::lock_guard guard(lock);
+        const FixedFormat format(out);
+        out << "{\"traceEvents\": [";
+        const char *sep = "\n";
+        for (const auto &span: spans) {
+            out << sep << R"(  {"ph": "X", "pid": 1, "tid": )" << span.thread << R"(, "name": ")" << span.name
+                << R"(", "ts": )" << micros(span.begin) << R"(, "dur": )"
+                << std::chrono::duration<double, std::micro>(span.end - span.begin).count() << "}";
+            sep = ",\n";
+        }
+        const auto end = micros(Clock::now());
+        for (const auto &[name, value]: counters) {
+            out << sep << R"(  {"ph": "C", "pid": 1, "tid": 0, "name": ")" << name << R"(", "ts": )" << end
+                << R"(, "args": {"value": )" << value.load() << "}}";
+            sep = ",\n";
+        }
+        out << "\n], \"displayTimeUnit\": \"ms\"}\n";
+    }
+
+private:
+    // Microsecond values with ns resolution, restoring the stream's format afterwards
+    struct FixedFormat {
+        explicit FixedFormat(std::ostream &out) : out{out}, flags{out.flags()}, precision{out.precision()} {
+            out << std::fixed << std::setprecision(3);
+        }
+
+        ~FixedFormat() {
+            out.flags(flags);
+            out.precision(precision);
+        }
+
+        std::ostream &out;
+        std::ios_base::fmtflags flags;
+        std::streamsize precision;
+    };
+
+    Registry() = default;
+
+    [[nodiscard]] double micros(Clock::time_point t) const {
+        return std::chrono::duration<double, std::micro>(t - origin).count();
+    }
+
+    static size_t lastBucket(const Histogram &h) {
+        size_t last = 0;
+        for (size_t b = 0; b < h.buckets.size(); ++b) {
+            if (0 != h.buckets[b].load()) {
+                last = b;
+            }
+        }
+        return last;
+    }
+
+    // name -> {count, total microseconds}
+    [[nodiscard]] std::map<std::string, std::pair<uint64_t, double> > spanTotals() const {
+        std::map<std::string, std::pair<uint64_t, double> > totals;
+        for (const auto &span: spans) {
+            auto &[count, total] = totals[span.name];
+            ++count;
+            total += std::chrono::duration<double, std::micro>(span.end - span.begin).count();
+        }
+        return totals;
+    }
+
+    std::mutex lock;
+    std::map<std::string, std::atomic<uint64_t> > counters;  // std::map nodes never move
+    std::map<std::string, Histogram> histograms;
+    std::vector<SpanEvent> spans;
+    Clock::time_point origin{Clock::now()};
+};
+
+class Span {
+public:
+    explicit Span(const char *name) : name{name}, begin{Clock::now()} {
+    }
+
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+
+    ~Span() {
+        static std::atomic<size_t> nextThread{1};
+        thread_local const size_t thread = nextThread.fetch_add(1);
+        Registry::instance().addSpan({name, thread, begin, Clock::now()});
+    }
+
+private:
+    const char *name;
+    Clock::time_point begin;
+};
+
+inline void reset() {
+    Registry::instance().reset();
+}
+
+inline void writeJson(std::ostream &out) {
+    Registry::instance().writeJson(out);
+}
+
+inline void writeChromeTrace(std::ostream &out) {
+    Registry::instance().writeChromeTrace(out);
+}
+
+}  // namespace aoc::trace
+
+#define AOC_TRACE_CONCAT_(a, b) a##b
+#define AOC_TRACE_CONCAT(a, b) AOC_TRACE_CONCAT_(a, b)
+
+#define AOC_TRACE_ADD(name, n)                                                             \
+    do {                                                                                   \
+        static auto &aocTraceCounter = aoc::trace::Registry::instance().counter(name);     \
+        aocTraceCounter.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);    \
+    } while (false)
+#define AOC_TRACE_COUNT(name) AOC_TRACE_ADD(name, 1)
+#define AOC_TRACE_HISTOGRAM(name, value)                                                   \
+    do {                                                                                   \
+        static auto &aocTraceHistogram = aoc::trace::Registry::instance().histogram(name); \
+        aocTraceHistogram.record(static_cast<uint64_t>(value));                            \
+    } while (false)
+#define AOC_TRACE_SPAN(name) const aoc::trace::Span AOC_TRACE_CONCAT(aocTraceSpan, __LINE__)(name)
+
+#else
+
+#include <ostream>
+
+namespace aoc::trace {
+
+inline constexpr bool enabled = false;
+
+inline void reset() {
+}
+
+inline void writeJson(std::ostream &) {
+}
+
+inline void writeChromeTrace(std::ostream &) {
+}
+
+}  // namespace aoc::trace
+
+#define AOC_TRACE_ADD(name, n) do {} while (false)
+#define AOC_TRACE_COUNT(name) do {} while (false)
+#define AOC_TRACE_HISTOGRAM(name, value) do {} while (false)
+#define AOC_TRACE_SPAN(name) do {} while (false)
+
+#endif  // AOC_TRACE
+
+#endif  // AOC_COMMON_TRACE_H
@@ -23,102 +23,223 @@
 // Advent of Code Day 1
 // https://adventofcode.com/2023/day/1
 
-
+#include <array>
+#include <chrono>
+#include <cstdint>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
-#include <cctype>
-#include <cstring>
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
+#include "../Common/ThreadPool.h"
 
 using namespace std;
 
+namespace day1 {
+
 const string file1 = "input1.txt";
 const string file2 = "input2.txt";
 
-vector<string> lines;
+constexpr array<string_view, 10> digitWords{"zero", "one", "two", "three", "four", "five", "six", "seven", "eight",
+                                            "nine"};
 
 /*
- * Reads an input text file into a vector array of strings
+ * Aho-Corasick automaton over the digit words, built at compile time. The reverse automaton
+ * spells every word backwards, so running it from the end of a line meets the last digit first.
  */
-void readfile(const string& inputFile, vector<string>& strLines) {
-    string line;
-    ifstream file(inputFile);
+template<bool Reverse>
+struct WordAutomaton {
+    static constexpr size_t maxStates = 41;  // the root and one state per letter of the words
+
+    array<array<uint8_t, 26>, maxStates> next{};
+    array<int8_t, maxStates> digit{};  // word completed on entering the state, or -1
+
+    constexpr WordAutomaton() {
+        digit.fill(-1);
+        uint8_t states = 1;
+        for (size_t d = 0; d < digitWords.size(); ++d) {
+            const auto word = digitWords[d];
+            uint8_t state = 0;
+            for (size_t i = 0; i < word.size(); ++i) {
+                const auto letter = static_cast<size_t>((Reverse ? word[word.size() - 1 - i] : word[i]) - 'a');
+                if (0 == next[state][letter]) {
+                    next[state][letter] = states++;
+                }
+                state = next[state][letter];
+            }
+            digit[state] = static_cast<int8_t>(d);
+        }
 
-    if (file.is_open()) {
-        while (getline(file, line)) {
-            strLines.push_back(line);
+        // breadth first over the trie: a missing edge becomes the edge of the failure state
+        array<uint8_t, maxStates> fail{};
+        array<uint8_t, maxStates> queue{};
+        size_t head = 0;
+        size_t tail = 0;
+        for (const auto child: next[0]) {
+            if (0 != child) {
+                queue[tail++] = child;
+            }
+        }
+        while (head < tail) {
+            const auto state = queue[head++];
+            if (digit[state] < 0) {
+                digit[state] = digit[fail[state]];
+            }
+            for (size_t letter = 0; letter < 26; ++letter) {
+                auto &child = next[state][letter];
+                if (0 == child) {
+                    child = next[fail[state]][letter];
+                } else {
+                    fail[child] = next[fail[state]][letter];
+                    queue[tail++] = child;
+                }
+            }
         }
-        file.close();
-    } else {
-        cout << "** Error: " << inputFile << " not found.";
     }
-}
+};
 
 /*
- * Finds the first digit in the line
+ * Value of the first digit met walking the line from the front, or from the back when
+ * Reverse is set. With Words, spelled out digits count as well. No digit at all gives 0.
  */
-int findFirstDigit(const string& str) {
-    for (char ch : str) {
-        if (isdigit(ch)) {
+template<bool Words, bool Reverse>
+static int scanDigit(string_view line) {
+    static constexpr WordAutomaton<Reverse> automaton;
+    uint8_t state = 0;
+    for (size_t i = 0; i < line.size(); ++i) {
+        const auto ch = static_cast<unsigned char>(line[Reverse ? line.size() - 1 - i : i]);
+        if (static_cast<unsigned>(ch - '0') < 10) {
             return ch - '0';
         }
+        if constexpr (Words) {
+            const auto letter = static_cast<unsigned>(ch - 'a');
+            state = letter < 26 ? automaton.next[state][letter] : 0;
+            if (automaton.digit[state] >= 0) {
+                return automaton.digit[state];
+            }
+        }
     }
-    return -1;
+    return 0;
 }
 
+template<bool Words>
+static int calibration(string_view line) {
+    return scanDigit<Words, false>(line) * 10 + scanDigit<Words, true>(line);
+}
+
+struct Totals {
+    uint64_t sum{};
+    uint64_t lines{};
+};
+
+template<bool Words>
+static Totals sumCalibration(string_view text) {
+    Totals totals;
+    aoc::forEachLine(text, [&totals](string_view line) {
+        totals.sum += calibration<Words>(line);
+        ++totals.lines;
+    });
+    return totals;
+}
+
+aoc::Answer solvePart1(string_view input) {
+    return to_string(sumCalibration<false>(input).sum);
+}
+
+aoc::Answer solvePart2(string_view input) {
+    return to_string(sumCalibration<true>(input).sum);
+}
+
+}  // namespace day1
+
+#ifndef AOC_LIBRARY
 /*
- * Finds the last digit in the line
+ * Splits text into about `chunks` pieces that end on a line break and sums them on the pool
  */
-int findLastDigit(const string& str) {
-    for (int i = static_cast<int>(str.length()) - 1; i >= 0; i--) {
-        if (isdigit(str[i])) {
-            return str[i] - '0';
-        }
+template<bool Words>
+static day1::Totals sumParallel(string_view text, aoc::ThreadPool &pool, size_t chunks) {
+    vector<future<day1::Totals> > parts;
+    size_t begin = 0;
+    for (size_t i = 1; i <= chunks && begin < text.size(); ++i) {
+        const auto nl = text.find('\n', max(begin, text.size() * i / chunks));
+        const auto end = string_view::npos == nl ? text.size() : nl + 1;
+        parts.push_back(pool.submit([chunk = text.substr(begin, end - begin)] {
+            return day1::sumCalibration<Words>(chunk);
+        }));
+        begin = end;
     }
-    return -1;
+    day1::Totals totals;
+    for (auto &part: parts) {
+        const auto [sum, lines] = part.get();
+        totals.sum += sum;
+        totals.lines += lines;
+    }
+    return totals;
 }
 
-int main() {
-    int total = 0;
-    int newTotal = 0;
+template<bool Words>
+static void report(const char *part, string_view text, aoc::ThreadPool &pool) {
+    const auto start = chrono::steady_clock::now();
+    const auto totals = sumParallel<Words>(text, pool, pool.size() * 8);
+    const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    cout << "  " << part << "\n"
+         << "    Sum of all calibration values: " << totals.sum << "\n"
+         << "    " << totals.lines << " lines in " << elapsed.count() << " s: "
+         << static_cast<uint64_t>(static_cast<double>(totals.lines) / elapsed.count()) << " lines/s\n";
+}
 
+/*
+ * Usage: Day_1 [<file> [--threads <n>]]
+ * Without arguments, solves the puzzle inputs. Given a file, maps it and runs both parts over
+ * it in parallel chunks, reporting the throughput; meant for calibration documents far larger
+ * than the puzzle input.
+ */
+int main(int argc, char *argv[]) {
     cout << "Day 1\n";
 
-    // PART 1
-    lines.clear();
-    readfile(file1, lines);
+    if (argc > 1) {
+        const string fileName = argv[1];
+        unsigned threads = thread::hardware_concurrency();
+        for (int i = 2; i < argc; ++i) {
+            const string arg = argv[i];
+            if ("--threads" == arg && i + 1 < argc) {
+                threads = static_cast<unsigned>(stoul(argv[++i]));
+            } else {
+                cerr << "Usage: " << argv[0] << " [<file> [--threads <n>]]" << endl;
+                return EXIT_FAILURE;
+            }
+        }
+        const aoc::MappedFile input(fileName);
+        if (!input) {
+            return EXIT_FAILURE;
+        }
+        aoc::ThreadPool pool(threads);
+        report<false>("Part 1", input.view(), pool);
+        report<true>("Part 2", input.view(), pool);
+        return 0;
+    }
 
-    for (const auto& line : lines) {
-        total += findFirstDigit(line) * 10 + findLastDigit(line);
+    // PART 1
+    const aoc::MappedFile input1(day1::file1);
+    if (!input1) {
+        return EXIT_FAILURE;
     }
 
     cout << "  Part 1\n"
-         << "    Sum of all calibration values: " << total << "\n";
+         << "    Sum of all calibration values: " << day1::solvePart1(input1.view()) << "\n";
 
     // PART 2
-    vector<string> newlines;
-    lines.clear();
-    readfile(file2, lines);
-
-    for (const auto& line : lines) {
-        string newline = line;
-        for (const auto& replacement : {"zero", "one", "two", "three", "four", "five", "six", "seven", "eight", "nine"}) {
-            size_t pos = newline.find(replacement);
-            while (pos != string::npos) {
-                newline.replace(pos, strlen(replacement), to_string(pos));
-                pos = newline.find(replacement, pos + 1);
-            }
-        }
-        newlines.push_back(newline);
-    }
-
-    for (const auto& newline : newlines) {
-        newTotal += findFirstDigit(newline) * 10 + findLastDigit(newline);
+    const aoc::MappedFile input2(day1::file2);
+    if (!input2) {
+        return EXIT_FAILURE;
     }
 
     cout << "  Part 2\n"
-         << "    Sum of all calibration values: " << newTotal << "\n";
+         << "    Sum of all calibration values: " << day1::solvePart2(input2.view()) << "\n";
 
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -21,273 +21,230 @@
  */
 
 // Advent of Code Day 10
-// https://adventofcode.com/2023/day/9
+// https://adventofcode.com/2023/day/10
 
-#include <algorithm>
-#include <fstream>
+#include <array>
+#include <bit>
 #include <iostream>
-#include <sstream>
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <numeric>
-#include <set>
-#include <array>
-#include <queue>
+#if __has_include("conmanip.h")
 #include "conmanip.h"
+#define HAS_CONMANIP
+#endif
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
 
 using namespace std;
-using Pos = array<int16_t, 2>;
-using Pipes = set<pair<Pos, Pos>>;
+
+namespace day10 {
 
 const string file1 = "input.txt";
 
+// Directions follow the repo convention: 0 = E, 1 = S, 2 = W, 3 = N
+constexpr array<int, 4> rowStep{0, 1, 0, -1};
+constexpr array<int, 4> colStep{1, 0, -1, 0};
+constexpr int8_t blocked = -1;
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
+// Heading after entering a tile while heading in each direction, or blocked
+constexpr auto turn = [] {
+    array<array<int8_t, 4>, 256> table{};
+    for (auto &headings: table) {
+        headings.fill(blocked);
     }
-
-    auto closeStream = [&in] {
-        in.close();
+    const auto pipe = [&table](char tile, int a, int b) {
+        // a pipe joining sides a and b is entered heading away from one of them
+        table[static_cast<unsigned char>(tile)][(a + 2) % 4] = static_cast<int8_t>(b);
+        table[static_cast<unsigned char>(tile)][(b + 2) % 4] = static_cast<int8_t>(a);
     };
+    pipe('|', 1, 3);
+    pipe('-', 0, 2);
+    pipe('L', 3, 0);
+    pipe('J', 3, 2);
+    pipe('7', 1, 2);
+    pipe('F', 1, 0);
+    return table;
+}();
+
+// One bit per tile, each row padded to whole words
+struct Bits {
+    size_t words{};  // per row
+    vector<uint64_t> bits;
+
+    Bits(size_t rows, size_t cols) : words{(cols + 63) / 64}, bits(rows * words) {
+    }
 
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
+    void set(size_t row, size_t col) {
+        bits[row * words + col / 64] |= uint64_t{1} << (col % 64);
     }
 
-    closeStream();
-    return true;
-}
+    bool test(size_t row, size_t col) const {
+        return bits[row * words + col / 64] >> (col % 64) & 1;
+    }
+};
 
-// breadth first search for flood fill
-size_t bfs(const Pipes &pipes, vector<string> &map) {
-    const Pos dim{static_cast<int16_t> (map.size()), static_cast<int16_t> (map[0].size())};
-    vector <vector<bool>> visited(map.size(), vector<bool>(map[0].size(), false));
-    queue <Pos> q{};
-    q.push({0, 0});
-    const auto isVisited = [&](const Pos &pos) {
-        return visited[pos[0]][pos[1]];
-    };
+struct Loop {
+    size_t length{};  // tiles, 0 when S is not on a loop
+    Bits pipe;        // tiles of the loop
+    Bits north;       // tiles of the loop with a pipe leaving north, S included
+};
 
-    const auto isPipe = [&pipes](const Pos &&src, const Pos &&dst) {
-        return pipes.find(std::pair(src, dst)) != pipes.end();
+/*
+ * Follows the pipes out of S in each direction in turn until one leads back to it, marking the
+ * tiles it passes in bitsets; S itself connects to the first and last sides the walk used.
+ */
+static Loop traceLoop(const vector<string_view> &rows) {
+    size_t width = 0;
+    for (const auto &row: rows) {
+        width = max(width, row.size());
+    }
+    const auto tile = [&rows](int64_t r, int64_t c) {
+        return r < 0 || c < 0 || static_cast<size_t>(r) >= rows.size() || static_cast<size_t>(c) >= rows[r].size()
+               ? '.' : rows[r][c];
     };
-    const auto updateQ = [&](const Pos &&next) {
-        if (!isVisited(next)) {
-            visited[next[0]][next[1]] = true;
-            q.push(next);
+    int64_t startRow = -1;
+    int64_t startCol = -1;
+    for (size_t r = 0; r < rows.size() && startRow < 0; ++r) {
+        if (const auto c = rows[r].find('S'); string_view::npos != c) {
+            startRow = static_cast<int64_t>(r);
+            startCol = static_cast<int64_t>(c);
         }
-    };
+    }
 
-    while (!q.empty()) {
-        auto pos = q.front();
-        q.pop();
-        const auto [r, c] = pos;
-        if (c < dim[1] - 1) {  // E
-            if (!isPipe({static_cast<short>(r), static_cast<short>(c + 1)},
-                        {static_cast<short>(r + 1), static_cast<short>(c + 1)})) {
-                updateQ({static_cast<short>(r), static_cast<short>(c + 1)});
+    for (int first = 0; first < 4 && startRow >= 0; ++first) {
+        Loop loop{0, Bits(rows.size(), width), Bits(rows.size(), width)};
+        int64_t r = startRow;
+        int64_t c = startCol;
+        int heading = first;
+        do {
+            loop.pipe.set(static_cast<size_t>(r), static_cast<size_t>(c));
+            if (3 == heading) {
+                loop.north.set(static_cast<size_t>(r), static_cast<size_t>(c));
             }
-        }
-        if (r < dim[0] - 1) {  // S
-            if (!isPipe({static_cast<short>(r + 1), c}, {static_cast<short>(r + 1), static_cast<short>(c + 1)})) {
-                updateQ({static_cast<short>(r + 1), c});
+            r += rowStep[heading];
+            c += colStep[heading];
+            ++loop.length;
+            // entering a tile from the north: the tile left behind had a pipe leaving south,
+            // the one entered has a pipe leaving north
+            if (1 == heading) {
+                loop.north.set(static_cast<size_t>(r), static_cast<size_t>(c));
             }
-        }
-        if (c > 0) {  // W
-            if (!isPipe({r, c}, {static_cast<short>(r + 1), c})) {
-                updateQ({r, static_cast<short>(c - 1)});
+            if (r == startRow && c == startCol) {
+                return loop;
             }
-        }
-        if (r > 0) {  // N
-            if (!isPipe({r, c}, {r, static_cast<short>(c + 1)})) {
-                updateQ({static_cast<short>(r - 1), c});
+            heading = turn[static_cast<unsigned char>(tile(r, c))][heading];
+        } while (blocked != heading);
+    }
+    return {0, Bits(0, 0), Bits(0, 0)};
+}
+
+/*
+ * Scanline crossing parity, 64 tiles at a time: a tile off the loop is inside when an odd
+ * number of loop tiles with a pipe leaving north lie before it on its row. A prefix XOR turns
+ * the word of north bits into the parity at every tile, carried from word to word. Calls
+ * f(row, word, inside) for every word of the rows.
+ */
+template<class F>
+static void forEachInside(const Loop &loop, F &&f) {
+    const auto words = loop.pipe.words;
+    for (size_t row = 0; words != 0 && row < loop.pipe.bits.size() / words; ++row) {
+        uint64_t carry = 0;
+        for (size_t word = 0; word < words; ++word) {
+            auto parity = loop.north.bits[row * words + word];
+            for (int shift = 1; shift < 64; shift *= 2) {
+                parity ^= parity << shift;
             }
+            parity ^= carry;
+            carry = 0 - (parity >> 63);
+            f(row, word, parity & ~loop.pipe.bits[row * words + word]);
         }
     }
+}
+
+aoc::Answer solvePart1(string_view input) {
+    return to_string(traceLoop(aoc::splitLines(input)).length / 2);
+}
+
+aoc::Answer solvePart2(string_view input) {
+    const auto loop = traceLoop(aoc::splitLines(input));
+    size_t inside = 0;
+    forEachInside(loop, [&inside](size_t, size_t, uint64_t mask) {
+        inside += static_cast<size_t>(popcount(mask));
+    });
+    return to_string(inside);
+}
+
+}  // namespace day10
+
+#ifndef AOC_LIBRARY
+/*
+ * Prints the map with the inside tiles in yellow, S in green, the loop in red and everything
+ * else in blue; through conmanip where it is available, ANSI escapes elsewhere
+ */
+static void render(string_view input) {
+    const auto rows = aoc::splitLines(input);
+    const auto loop = day10::traceLoop(rows);
+    day10::Bits inside(rows.size(), loop.pipe.words * 64);
+    day10::forEachInside(loop, [&inside](size_t row, size_t word, uint64_t mask) {
+        inside.bits[row * inside.words + word] = mask;
+    });
+
+#ifdef HAS_CONMANIP
     using namespace conmanip;
     console_out_context ctxOut;
     console_out conOut(ctxOut);
-
-    size_t count{};
-    for (int16_t r = 0; r < dim[0] - 2; ++r) {
-        for (int16_t c = 0; c < dim[1] - 2; ++c) {
-            const auto isInside =
-                    !isVisited({r, c}) && !isVisited({r, static_cast<short>(c + 1)}) &&
-                    !isVisited({static_cast<short>(r + 1), c}) &&
-                    !isVisited({static_cast<short>(r + 1), static_cast<short>(c + 1)});
-            if (isInside) {
-                count++;
-            }
-            // colorize
-            if (isInside) {
-                std::cout << settextcolor(console_text_colors::light_yellow) << map[r + 1][c + 1];
-            } else if ('S' == map[r + 1][c + 1]) {
-                std::cout << settextcolor(console_text_colors::light_green) << map[r + 1][c + 1];
-            } else if (isPipe({static_cast<short>(r + 1), static_cast<short>(c + 1)},
-                              {static_cast<short>(r + 2), static_cast<short>(c + 1)}) ||
-                       isPipe({static_cast<short>(r + 1), static_cast<short>(c + 1)},
-                              {static_cast<short>(r + 1), static_cast<short>(c + 2)}) ||
-                       isPipe({r, static_cast<short>(c + 1)}, {static_cast<short>(r + 1), static_cast<short>(c + 1)}) ||
-                       isPipe({static_cast<short>(r + 1), c}, {static_cast<short>(r + 1), static_cast<short>(c + 1)})) {
-                std::cout << settextcolor(console_text_colors::light_red) << map[r + 1][c + 1];
-            } else {
-                std::cout << settextcolor(console_text_colors::blue) << map[r + 1][c + 1];
-            }
+    const auto color = [](char tile, bool in, bool pipe) {
+        return settextcolor(in ? console_text_colors::light_yellow : 'S' == tile ? console_text_colors::light_green
+                            : pipe ? console_text_colors::light_red : console_text_colors::blue);
+    };
+#else
+    const auto color = [](char tile, bool in, bool pipe) {
+        return in ? "\033[93m" : 'S' == tile ? "\033[92m" : pipe ? "\033[91m" : "\033[34m";
+    };
+#endif
+    for (size_t r = 0; r < rows.size(); ++r) {
+        for (size_t c = 0; c < rows[r].size(); ++c) {
+            const auto pipe = 0 != loop.length && loop.pipe.test(r, c);
+            cout << color(rows[r][c], 0 != loop.length && inside.test(r, c), pipe) << rows[r][c];
         }
-        // colorize
-        std::cout << '\n';
+        cout << '\n';
     }
-
+#ifdef HAS_CONMANIP
     ctxOut.restore(console_cleanup_options::restore_attibutes);
-    return count;
-
+#else
+    cout << "\033[0m";
+#endif
 }
 
-int main() {
+/*
+ * Usage: Day_10 [--render]
+ * --render also prints the map, coloured by where each tile lies relative to the loop.
+ */
+int main(int argc, char *argv[]) {
+    const bool draw = argc > 1 && string_view("--render") == argv[1];
+    if (argc > (draw ? 2 : 1)) {
+        cerr << "Usage: " << argv[0] << " [--render]" << endl;
+        return EXIT_FAILURE;
+    }
 
     cout << "Day 10" << endl;
 
-    vector<string> map{};
-    if (!readFile(file1, map)) {
+    const aoc::MappedFile input(day10::file1);
+    if (!input) {
         return EXIT_FAILURE;
     }
 
-    const Pos dim{static_cast<int16_t> (map.size()), static_cast<int16_t> (map.begin()->length())};
-
-    map.insert(map.begin(), string(dim[1], '.'));
-    map.emplace_back(dim[1], '.');
-    transform(map.begin(), map.end(), map.begin(), [](auto &row) { return '.' + std::move(row) + '.'; });
-
-    const auto getStart = [&]() -> Pos {
-        for (int16_t row = 1; row < dim[0] - 1; ++row) {
-            for (int16_t col = 1; col < dim[1] - 1; ++col) {
-                if ('S' == map[row][col]) {
-                    return {row, col};
-                }
-            }
-        }
-        return {0, 0};
-    };
-
-    const auto start = getStart();
-    Pipes pipes;
-
-    { // Part 1
-        const int16_t size = 4;
-        constexpr array<Pos, size> adjs = {{{0, 1}, {1, 0}, {0, -1}, {-1, 0}}};
-        size_t max{};
-        vector<int16_t> dirs;
-
-        for (int16_t i = 0; i < static_cast<int16_t>(adjs.size()); ++i) {
-            auto dir = i;
-            if (find(dirs.begin(), dirs.end(), dir) != dirs.end()) {
-                continue;
-            }
-            dirs.push_back(dir);
-            Pos pos = {static_cast<int16_t>(start[0] + adjs[i][0]), static_cast<int16_t>(start[1] + adjs[i][1])};
-            auto &[row, col] = pos;
-
-            if (row < 0 || col < 0) {
-                continue;
-            }
-            size_t steps{1};
-            Pipes loop{};
+    cout << "  Part 1" << endl;
+    cout << "     Longest distance : " << day10::solvePart1(input.view()) << endl;
 
-            if (0 == dir || 1 == dir) {
-                loop.insert({start, pos});
-            } else {
-                loop.insert({pos, start});
-            }
-            while (pos != start) {
-                auto src = pos;
-                if (0 == dir) {  // East
-                    if ('-' == map[row][col]) {
-                        col++;
-                    } else if ('7' == map[row][col]) {
-                        row++;
-                        dir = 1;
-                    } else if ('J' == map[row][col]) {
-                        row--;
-                        dir = 3;
-                    } else {
-                        steps = 0;
-                        break;
-                    }
-                } else if (1 == dir) {  // South
-                    if ('|' == map[row][col]) {
-                        row++;
-                    } else if ('J' == map[row][col]) {
-                        col--;
-                        dir = 2;
-                    } else if ('L' == map[row][col]) {
-                        col++;
-                        dir = 0;
-                    } else {
-                        steps = 0;
-                        break;
-                    }
-                } else if (2 == dir) { // West
-                    if ('-' == map[row][col]) {
-                        col--;
-                    } else if ('L' == map[row][col]) {
-                        row--;
-                        dir = 3;
-                    } else if ('F' == map[row][col]) {
-                        row++;
-                        dir = 1;
-                    } else {
-                        steps = 0;
-                        break;
-                    }
-                } else if (3 == dir) { // North
-                    if ('|' == map[row][col]) {
-                        row--;
-                    } else if ('F' == map[row][col]) {
-                        col++;
-                        dir = 0;
-                    } else if ('7' == map[row][col]) {
-                        col--;
-                        dir = 2;
-                    } else {
-                        steps = 0;
-                        break;
-                    }
-                }
-                steps++;
-                if (0 == dir || 1 == dir) {
-                    loop.insert({src, pos});
-                } else {
-                    loop.insert({pos, src});
-                }
-                loop.insert({pos, src});
-            }
-
-            if (const auto steps2 = steps / 2; steps > 0) {
-
-                const int16_t adder = 2;
-
-                dirs.push_back(static_cast<int16_t>((dir + adder) % size));
-                if (steps2 > max) {
-                    max = steps2;
-                    pipes = std::move(loop);
-                }
-            }
-        }
-        cout << "  Part 1" << endl;
-        cout << "     Longest distance : " << max << endl;
+    if (draw) {
+        render(input.view());
     }
 
-    {  // Part 2
-
-        const auto count = bfs(pipes, map);
-        cout << "  Part 2" << endl;
-        cout << "     Enclosed tiles : " << count << endl;
-    }
+    cout << "  Part 2" << endl;
+    cout << "     Enclosed tiles : " << day10::solvePart2(input.view()) << endl;
 
     return EXIT_SUCCESS;
 }
+#endif
@@ -23,126 +23,135 @@
 // Advent of Code Day 11
 // https://adventofcode.com/2023/day/11
 
-#include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <algorithm>
+#include <span>
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
 
 using namespace std;
 
-const string file1 = "input.txt";
+namespace day11 {
 
-using Pos = pair<uint16_t, uint16_t>;
+const string file1 = "input.txt";
 
-int64_t manhattanDistance(const Pos &a, const Pos &b) {
-    return abs(a.first - b.first) + abs(a.second - b.second);
-}
+/*
+ * Expanding every empty row and column `factor` times moves each galaxy by factor - 1 for every
+ * empty line before it, and keeps the galaxies in the same order along both axes. The sum of
+ * the distances between all pairs is therefore linear in the factor:
+ *   base + (factor - 1) * crossings
+ * where base is the sum for the image as it is and crossings counts the empty lines between
+ * the two galaxies of every pair.
+ */
+struct Distances {
+    uint64_t base{};
+    uint64_t crossings{};
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
+    uint64_t total(uint64_t factor) const {
+        return base + (factor - 1) * crossings;
     }
 
-    auto closeStream = [&in] {
-        in.close();
-    };
+    // The totals for a whole sweep of factors, without going back to the image
+    vector<uint64_t> totals(span<const uint64_t> factors) const {
+        vector<uint64_t> sums;
+        sums.reserve(factors.size());
+        for (const auto factor: factors) {
+            sums.push_back(total(factor));
+        }
+        return sums;
+    }
+};
 
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
+/*
+ * Adds one axis to the sums: with the galaxies counted per line, the lines visited in order
+ * give every galaxy's distance to all the galaxies before it from running prefix sums of their
+ * coordinates and of the empty lines before them, with no pair ever visited.
+ */
+static void addAxis(const vector<uint64_t> &counts, Distances &distances) {
+    uint64_t galaxies{};    // before the current line
+    uint64_t positions{};   // sum of their coordinates
+    uint64_t emptyLines{};  // empty lines before the current line
+    uint64_t expansions{};  // sum of the empty lines before each of the galaxies
+    for (uint64_t line = 0; line < counts.size(); ++line) {
+        if (0 == counts[line]) {
+            ++emptyLines;
+            continue;
+        }
+        distances.base += counts[line] * (line * galaxies - positions);
+        distances.crossings += counts[line] * (emptyLines * galaxies - expansions);
+        galaxies += counts[line];
+        positions += counts[line] * line;
+        expansions += counts[line] * emptyLines;
     }
+}
 
-    closeStream();
-    return true;
+// One pass over the image counting galaxies per row and per column
+static Distances toDistances(string_view input) {
+    vector<uint64_t> rows;
+    vector<uint64_t> cols;
+    aoc::forEachLine(input, [&rows, &cols](string_view line) {
+        if (cols.size() < line.size()) {
+            cols.resize(line.size());
+        }
+        uint64_t count{};
+        for (auto c = line.find('#'); string_view::npos != c; c = line.find('#', c + 1)) {
+            ++cols[c];
+            ++count;
+        }
+        rows.push_back(count);
+    });
+    Distances distances;
+    addAxis(rows, distances);
+    addAxis(cols, distances);
+    return distances;
 }
 
-int main() {
+aoc::Answer solvePart1(string_view input) {
+    return to_string(toDistances(input).total(2));
+}
 
-    cout << "Day 11" << endl;
+aoc::Answer solvePart2(string_view input) {
+    return to_string(toDistances(input).total(1000000));
+}
 
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
-        return EXIT_FAILURE;
-    }
+}  // namespace day11
 
-    vector<size_t> rowExpansions;
-    for (size_t r = 0; r < lines.size(); ++r) {
-        bool shouldExpand = true;
-        for (char c : lines[r]) {
-            if (c == '#') {
-                shouldExpand = false;
-                break;
-            }
-        }
-        if (shouldExpand) {
-            rowExpansions.push_back(r);
-        }
-    }
-    vector<size_t> colExpansions;
-    for (size_t c = 0; c < lines[0].size(); ++c) {
-        bool shouldExpand = true;
-        for (auto & line : lines) {
-            if (line[c] == '#') {
-                shouldExpand = false;
-                break;
-            }
-        }
-        if (shouldExpand) {
-            colExpansions.push_back(c);
+#ifndef AOC_LIBRARY
+/*
+ * Usage: Day_11 [--factor <n>]...
+ * Every --factor also prints the sum of the distances for that expansion factor.
+ */
+int main(int argc, char *argv[]) {
+    vector<uint64_t> factors;
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        if ("--factor" == arg && i + 1 < argc) {
+            factors.push_back(stoull(argv[++i]));
+        } else {
+            cerr << "Usage: " << argv[0] << " [--factor <n>]..." << endl;
+            return EXIT_FAILURE;
         }
     }
 
-    vector<Pos> positions;
-    for (size_t r = 0; r < lines.size(); ++r) {
-        for (size_t c = 0; c < lines[r].size(); ++c) {
-            if (lines[r][c] == '#') {
-                positions.emplace_back(r, c);
-            }
-        }
-    }
+    cout << "Day 11" << endl;
 
-    {  // Part 1
-        uint64_t sum{};
-        for (size_t i = 0; i < positions.size(); ++i) {
-            for (size_t j = i + 1; j < positions.size(); ++j) {
-                sum += manhattanDistance(positions[i], positions[j]);
-                for (const auto r: rowExpansions) {
-                    if ((positions[i].first < r && r < positions[j].first) || (positions[j].first < r && r < positions[i].first)) {
-                        sum += 2 - 1;
-                    }
-                }
-                for (const auto c: colExpansions) {
-                    if ((positions[i].second < c && c < positions[j].second) || (positions[j].second < c && c < positions[i].second)) {
-                        sum += 2 - 1;
-                    }
-                }
-            }
-        }
-        cout << sum << endl;
+    const aoc::MappedFile input(day11::file1);
+    if (!input) {
+        return EXIT_FAILURE;
     }
-    {  // Part 2
-        uint64_t sum{};
-        for (size_t i = 0; i < positions.size(); ++i) {
-            for (size_t j = i + 1; j < positions.size(); ++j) {
-                sum += manhattanDistance(positions[i], positions[j]);
-                for (const auto r: rowExpansions) {
-                    if ((positions[i].first < r && r < positions[j].first) || (positions[j].first < r && r < positions[i].first)) {
-                        sum += 1000000 - 1;
-                    }
-                }
-                for (const auto c: colExpansions) {
-                    if ((positions[i].second < c && c < positions[j].second) || (positions[j].second < c && c < positions[i].second)) {
-                        sum += 1000000 - 1;
-                    }
-                }
-            }
+
+    cout << day11::solvePart1(input.view()) << endl;
+    cout << day11::solvePart2(input.view()) << endl;
+
+    if (!factors.empty()) {
+        const auto totals = day11::toDistances(input.view()).totals(factors);
+        for (size_t i = 0; i < factors.size(); ++i) {
+            cout << "factor " << factors[i] << " : " << totals[i] << endl;
         }
-        cout << sum << endl;
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
@@ -23,151 +23,186 @@
 // Advent of Code Day 12
 // https://adventofcode.com/2023/day/12
 
-#include <cassert>
-#include <fstream>
+#include <algorithm>
 #include <iostream>
-#include <map>
-#include <memory>
-#include <sstream>
 #include <string>
 #include <vector>
+#include <cstdint>
+#include "../Common/Input.h"
+#include "../Common/Parse.h"
+#include "../Common/Solver.h"
+#include "../Common/ThreadPool.h"
+#include "../Common/Trace.h"
 
 using namespace std;
 
+namespace day12 {
+
 const string file1 = "input.txt";
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
+// a chunk this small is not worth a thread
+constexpr size_t bytesPerChunk = 1 << 16;
 
-    auto closeStream = [&in] {
-        in.close();
-    };
-
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
-    }
+// Buffers reused from row to row, so counting allocates only while they grow
+struct Workspace {
+    string springs;
+    vector<uint32_t> sizes;  // of the groups of the row as written
+    vector<uint32_t> groups;
+    vector<uint32_t> run;    // length of the run of non-'.' springs ending at each position
+    vector<uint64_t> ways;   // (springs + 1) x (groups + 1), row by row
+};
 
-    closeStream();
-    return true;
-}
-
-using Group = vector<uint32_t>;
-using Puzzle = pair<string, Group>;
-using Puzzles = vector<Puzzle>;
-
-template <size_t FOLD = 1, bool WITH_CACHE = true>
-static size_t count(const string& p, const Group& g, size_t pos = 0, size_t k = 0,
-                    shared_ptr<map<pair<size_t, size_t>, size_t> > cache = nullptr)
-{
-    if constexpr (WITH_CACHE) {
-        assert(nullptr != cache);
-        if (const auto it = cache->find({pos, k}); it != cache->end()) {
-            return it->second;
+/*
+ * Arrangements of one row, unfolded `fold` times: ways[i][k] counts the ways of filling the
+ * first i springs with exactly the first k groups, spring i - 1 not being inside a group. From
+ * there spring i is either working, unless it is '#', or starts group k, which fits when the
+ * run of non-'.' springs ending where it would end is long enough and the spring after it is
+ * not '#'. A '.' appended to the row means every group has a spring after it. The counts wrap
+ * past 2^64, which large folds can reach.
+ */
+static uint64_t count(string_view springs, span<const uint32_t> groups, size_t fold, Workspace &work) {
+    auto &row = work.springs;
+    row.clear();
+    work.groups.clear();
+    for (size_t copy = 0; copy < fold; ++copy) {
+        if (0 != copy) {
+            row += '?';
         }
+        row += springs;
+        work.groups.insert(work.groups.end(), groups.begin(), groups.end());
     }
-    if (pos == p.size() && k == FOLD * g.size()) {
-        return 1;
+    row += '.';
+
+    const auto n = row.size();
+    const auto m = work.groups.size();
+    work.run.resize(n);
+    uint32_t run = 0;
+    for (size_t i = 0; i < n; ++i) {
+        run = '.' == row[i] ? 0 : run + 1;
+        work.run[i] = run;
     }
-    if (pos >= p.size()) {
-        return 0;
-    }
-    if ('#' == p[pos]) {
-        if (k >= FOLD * g.size() || pos + g[k % g.size()] >= p.size()) {
-            return 0;
-        }
-        for (size_t c = 1; c < g[k % g.size()]; ++c) {
-            if ('.' == p[pos + c]) {
-                return 0;
+
+    auto &ways = work.ways;
+    ways.assign((n + 1) * (m + 1), 0);
+    const auto at = [m](size_t i, size_t k) {
+        return i * (m + 1) + k;
+    };
+    ways[at(0, 0)] = 1;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t k = 0; k <= m; ++k) {
+            const auto here = ways[at(i, k)];
+            if (0 == here) {
+                continue;
+            }
+            if ('#' != row[i]) {
+                ways[at(i + 1, k)] += here;
+            }
+            if (k < m) {
+                const size_t end = i + work.groups[k];  // the spring after the group
+                if (end < n && work.run[end - 1] >= work.groups[k] && '#' != row[end]) {
+                    ways[at(end + 1, k + 1)] += here;
+                }
             }
         }
-        pos += g[k % g.size()];
-        k++;
-        if ('#' == p[pos]) {
-            return 0;
+    }
+    AOC_TRACE_HISTOGRAM("day12.dp.cells", ways.size());
+    return ways[at(n, m)];
+}
+
+static uint64_t sumChunk(string_view text, size_t fold) {
+    Workspace work;
+    uint64_t sum{};
+    aoc::forEachLine(text, [&](string_view line) {
+        const auto space = line.find(' ');
+        if (string_view::npos == space) {
+            return;
         }
-        const auto s = count<FOLD, WITH_CACHE>(p, g, pos + 1, k, cache);
-        if constexpr (WITH_CACHE) {
-            cache->insert({{pos + 1, k}, s});
+        // parsed again only when the row has more groups than any before it
+        auto &sizes = work.sizes;
+        sizes.resize(sizes.capacity());
+        const auto n = aoc::parseIntegers(line.substr(space + 1), span(sizes));
+        const auto fits = n <= sizes.size();
+        sizes.resize(n);
+        if (!fits) {
+            aoc::parseIntegers(line.substr(space + 1), span(sizes));
         }
-        return s;
+        sum += count(line.substr(0, space), sizes, fold, work);
+    });
+    return sum;
+}
+
+/*
+ * Sum of the arrangements of every row unfolded `fold` times. Inputs past one chunk are cut
+ * into newline-aligned chunks that are counted in parallel.
+ */
+static uint64_t sumArrangements(string_view input, size_t fold) {
+    const auto chunks = max<size_t>(1, input.size() / bytesPerChunk);
+    vector<string_view> parts;
+    size_t begin = 0;
+    for (size_t i = 1; i <= chunks && begin < input.size(); ++i) {
+        const auto nl = input.find('\n', max(begin, input.size() * i / chunks));
+        const auto end = string_view::npos == nl ? input.size() : nl + 1;
+        parts.push_back(input.substr(begin, end - begin));
+        begin = end;
     }
-    if ('.' == p[pos]) {
-        return count<FOLD, WITH_CACHE>(p, g, pos + 1, k, cache);
+    vector<uint64_t> sums(parts.size());
+    aoc::ThreadPool::global().parallelFor(parts.size(), [&](size_t part) {
+        sums[part] = sumChunk(parts[part], fold);
+    });
+    uint64_t sum{};
+    for (const auto s: sums) {
+        sum += s;
     }
-    const string p1 = p.substr(0, pos) + '#' + p.substr(pos + 1, p.size() - pos - 1);
-    const string p2 = p.substr(0, pos) + '.' + p.substr(pos + 1, p.size() - pos - 1);
-    return count<FOLD, WITH_CACHE>(p1, g, pos, k, cache) + count<FOLD, WITH_CACHE>(p2, g, pos, k, cache);
+    return sum;
 }
 
-static inline size_t count1(const string& p, const Group& g)
-{
-    return count<1, false>(p, g);
+aoc::Answer solvePart1(string_view input) {
+    AOC_TRACE_SPAN("day12.part1");
+    return to_string(sumArrangements(input, 1));
 }
 
-static inline size_t count5(const string& p, const Group& g)
-{
-    return count<5>(p, g, 0, 0, make_shared<map<pair<size_t, size_t>, size_t> >());
+aoc::Answer solvePart2(string_view input) {
+    AOC_TRACE_SPAN("day12.part2");
+    return to_string(sumArrangements(input, 5));
 }
 
-int main() {
+}  // namespace day12
+
+#ifndef AOC_LIBRARY
+/*
+ * Usage: Day_12 [--fold <n>]...
+ * Every --fold also prints the sum of the arrangements with the rows unfolded n times.
+ */
+int main(int argc, char *argv[]) {
+    vector<size_t> folds;
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        if ("--fold" == arg && i + 1 < argc) {
+            folds.push_back(stoull(argv[++i]));
+        } else {
+            cerr << "Usage: " << argv[0] << " [--fold <n>]..." << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
     cout << "Day 12" << endl;
 
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
+    const aoc::MappedFile input(day12::file1);
+    if (!input) {
         return EXIT_FAILURE;
     }
 
-    {  // Part 1
-        Puzzles puzzles;
-        for (const auto& line : lines) {
-            uint32_t x;
-            string p;
-            istringstream iss{line};
-            iss >> p;
-            p += '.';
-            Group g;
-            while (iss >> x) {
-                g.push_back(x);
-                iss.ignore(1);
-            }
-            puzzles.emplace_back(p, g);
-        }
+    cout << "  Part 1" << endl;
+    cout << "     Sum of possible arrangements : " << day12::solvePart1(input.view()) << endl;
 
-        size_t sum{};
-        for (const auto& [p, g] : puzzles) {
-            sum += count1(p, g);
-        }
-        cout << "  Part 1" << endl;
-        cout << "     Sum of possible arrangements : " << sum << endl;
-    }
-    {  // Part 2
-        Puzzles puzzles;
-        for (const auto& line : lines) {
-            uint32_t x;
-            string p;
-            istringstream iss{line};
-            iss >> p;
-            p = p + '?' + p + '?' + p + '?' + p + '?' + p + '.';
-            Group g;
-            while (iss >> x) {
-                g.push_back(x);
-                iss.ignore(1);
-            }
-            puzzles.emplace_back(p, g);
-        }
+    cout << "  Part 2" << endl;
+    cout << "     Sum of possible arrangements : " << day12::solvePart2(input.view()) << endl;
 
-        size_t sum{};
-        for (const auto& [p, g] : puzzles) {
-            sum += count5(p, g);
-        }
-        cout << "  Part 2" << endl;
-        cout << "     Sum of possible arrangements : " << sum << endl;
+    for (const auto fold: folds) {
+        cout << "  Folded " << fold << " times" << endl;
+        cout << "     Sum of possible arrangements : " << day12::sumArrangements(input.view(), fold) << endl;
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
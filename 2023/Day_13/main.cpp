@@ -23,42 +23,225 @@
 // Advent of Code Day 13
 // https://adventofcode.com/2023/day/13
 
-#include <cassert>
-#include <fstream>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <numeric>
+#include <span>
 #include <string>
 #include <vector>
-#include <numeric>
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DAY13_POPCNT 1
+#endif
 
 using namespace std;
 
+namespace day13 {
+
 const string file1 = "sample.txt";
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
+constexpr size_t maxSide = 64;
+
+/*
+ * Every pattern of the input as bitmasks with '#' set, all in one vector: a word per row, bit c
+ * for column c, followed by a word per column, bit r for row r, so that comparing two lines is
+ * an XOR and the cells where they differ its popcount. Patterns are at most maxSide by maxSide.
+ */
+class Patterns {
+public:
+    explicit Patterns(string_view input) {
+        masks_.reserve(input.size() / 4);
+        vector<string_view> lines;
+        aoc::forEachLine(input, [this, &lines](string_view line) {
+            if (!line.empty()) {
+                lines.push_back(line);
+            } else if (!lines.empty()) {
+                add(lines);
+                lines.clear();
+            }
+        });
+        if (!lines.empty()) {
+            add(lines);
+        }
+    }
+
+    size_t size() const {
+        return shapes_.size();
     }
 
-    auto closeStream = [&in] {
-        in.close();
+    span<const uint64_t> rows(size_t pattern) const {
+        const auto &shape = shapes_[pattern];
+        return span(masks_).subspan(shape.offset, shape.rows);
+    }
+
+    span<const uint64_t> cols(size_t pattern) const {
+        const auto &shape = shapes_[pattern];
+        return span(masks_).subspan(shape.offset + shape.rows, shape.cols);
+    }
+
+private:
+    struct Shape {
+        size_t offset;
+        uint32_t rows;
+        uint32_t cols;
     };
 
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
+    static constexpr uint64_t lowBits = 0x0101010101010101;
+
+    static uint64_t load(const char *chars) {
+        uint64_t eight;
+        memcpy(&eight, chars, sizeof(eight));
+        return eight;
     }
 
-    closeStream();
-    return true;
+    // Bit c of a line set for a '#' at c: '#' has bit 0 set and '.' has not, and eight of those
+    // bits at a time are gathered into the top byte by a multiply that cannot carry
+    static uint64_t encode(string_view line) {
+        uint64_t bits{};
+        size_t c = 0;
+        for (; c + 8 <= line.size(); c += 8) {
+            bits |= ((load(line.data() + c) & lowBits) * 0x0102040810204080 >> 56) << c;
+        }
+        for (; c < line.size(); ++c) {
+            bits |= static_cast<uint64_t>('#' == line[c]) << c;
+        }
+        return bits;
+    }
+
+    /*
+     * Rows are encoded line by line; columns eight by eight from the same bytes, where the low
+     * bits of eight lines' chunks shifted by line make each byte eight rows of one column.
+     */
+    void add(span<const string_view> lines) {
+        const auto width = lines[0].size();
+        if (lines.size() > maxSide || width > maxSide) {
+            cerr << "Pattern over " << maxSide << " lines or columns" << endl;
+            return;
+        }
+        if (any_of(lines.begin(), lines.end(), [width](string_view line) { return line.size() != width; })) {
+            cerr << "Pattern with lines of different lengths" << endl;
+            return;
+        }
+        const auto offset = masks_.size();
+        masks_.resize(offset + lines.size() + width);
+        const auto rows = span(masks_).subspan(offset, lines.size());
+        const auto cols = span(masks_).subspan(offset + lines.size(), width);
+        for (size_t r = 0; r < lines.size(); ++r) {
+            rows[r] = encode(lines[r]);
+        }
+        size_t c = 0;
+        for (; c + 8 <= width; c += 8) {
+            for (size_t r = 0; r < lines.size(); r += 8) {
+                uint64_t block{};
+                for (size_t i = 0; i < min<size_t>(8, lines.size() - r); ++i) {
+                    block |= (load(lines[r + i].data() + c) & lowBits) << i;
+                }
+                for (size_t j = 0; j < 8; ++j) {
+                    cols[c + j] |= (block >> 8 * j & 0xff) << r;
+                }
+            }
+        }
+        for (; c < width; ++c) {
+            for (size_t r = 0; r < lines.size(); ++r) {
+                cols[c] |= (rows[r] >> c & 1) << r;
+            }
+        }
+        shapes_.push_back({offset, static_cast<uint32_t>(lines.size()), static_cast<uint32_t>(width)});
+    }
+
+    vector<Shape> shapes_;
+    vector<uint64_t> masks_;
+};
+
+/*
+ * The first line of reflection, as the number of lines before it, at which the mirrored pairs
+ * differ in exactly `smudges` cells, or 0 if there is none. An axis is dropped as soon as its
+ * count goes over.
+ */
+static inline size_t mirror(span<const uint64_t> lines, unsigned smudges) {
+    for (size_t axis = 1; axis < lines.size(); ++axis) {
+        const auto reach = min(axis, lines.size() - axis);
+        unsigned diff{};
+        for (size_t i = 0; i < reach && diff <= smudges; ++i) {
+            diff += static_cast<unsigned>(popcount(lines[axis - 1 - i] ^ lines[axis + i]));
+        }
+        if (smudges == diff) {
+            return axis;
+        }
+    }
+    return 0;
 }
 
+// 100 times the rows above a horizontal line of reflection, or else the columns left of a vertical one
+static inline size_t summarize(const Patterns &patterns, size_t pattern, unsigned smudges) {
+    if (const auto r = mirror(patterns.rows(pattern), smudges); r > 0) {
+        return 100 * r;
+    }
+    return mirror(patterns.cols(pattern), smudges);
+}
+
+static void summarizeScalar(const Patterns &patterns, unsigned smudges, span<uint32_t> out) {
+    for (size_t pattern = 0; pattern < patterns.size(); ++pattern) {
+        out[pattern] = static_cast<uint32_t>(summarize(patterns, pattern, smudges));
+    }
+}
+
+#ifdef DAY13_POPCNT
+static bool hasPopcnt() {
+    static const bool supported = __builtin_cpu_supports("popcnt");
+    return supported;
+}
+
+// The same loop with mirror inlined where popcount is one instruction instead of a bit trick
+__attribute__((target("popcnt"))) static void summarizePopcnt(const Patterns &patterns, unsigned smudges,
+                                                               span<uint32_t> out) {
+    for (size_t pattern = 0; pattern < patterns.size(); ++pattern) {
+        out[pattern] = static_cast<uint32_t>(summarize(patterns, pattern, smudges));
+    }
+}
+#endif
+
+// Every pattern's summary, out must have room for patterns.size()
+static void summarize(const Patterns &patterns, unsigned smudges, span<uint32_t> out) {
+#ifdef DAY13_POPCNT
+    if (hasPopcnt()) {
+        summarizePopcnt(patterns, smudges, out);
+        return;
+    }
+#endif
+    summarizeScalar(patterns, smudges, out);
+}
+
+static size_t total(const Patterns &patterns, unsigned smudges) {
+    vector<uint32_t> summaries(patterns.size());
+    summarize(patterns, smudges, summaries);
+    return accumulate(summaries.begin(), summaries.end(), size_t{});
+}
+
+aoc::Answer solvePart1(string_view input) {
+    return to_string(total(Patterns(input), 0));
+}
+
+aoc::Answer solvePart2(string_view input) {
+    return to_string(total(Patterns(input), 1));
+}
+
+}  // namespace day13
+
+#ifndef AOC_LIBRARY
+// The character by character search the bitmasks replaced, kept to check and time them against
+namespace reference {
 
 template <size_t TARGETDIFF = 0>
-static size_t isvMirror(const std::vector<std::string>& map)
+static size_t isvMirror(const std::vector<std::string_view>& map)
 {
-    size_t c, diff;
+    size_t c, diff{};
     for (c = 1; c < map[0].size(); ++c) {
         diff = 0;
         size_t mm{1}, cc{c};
@@ -84,9 +267,9 @@ static size_t isvMirror(const std::vector<std::string>& map)
 }
 
 template <size_t TARGETDIFF = 0>
-static size_t ishMirror(const std::vector<std::string>& map)
+static size_t ishMirror(const std::vector<std::string_view>& map)
 {
-    size_t r, diff;
+    size_t r, diff{};
     for (r = 1; r < map.size(); ++r) {
         diff = 0;
         size_t mm{1}, rr{r};
@@ -112,53 +295,114 @@ static size_t ishMirror(const std::vector<std::string>& map)
 }
 
 template <size_t TARGETDIFF = 0>
-static size_t pattern(size_t& s, const std::vector<std::string>& map)
+static size_t pattern(const std::vector<std::string_view>& map)
 {
     if (const auto r = ishMirror<TARGETDIFF>(map); r > 0) {
-        s += 100 * r;
-    } else {
-        s += isvMirror<TARGETDIFF>(map);
+        return 100 * r;
     }
-    return s;
+    return isvMirror<TARGETDIFF>(map);
 }
 
-int main()
-{
-    cout << "Day 13" << endl;
+static vector<vector<string_view> > toMaps(string_view input) {
+    std::vector<std::vector<std::string_view> > maps;
+    std::vector<std::string_view> map;
+    auto lines = aoc::splitLines(input);
+    lines.emplace_back();
+    for (auto& line : lines) {
+        if (line.empty() && !map.empty()) {
+            maps.push_back(map);
+            map.clear();
+            continue;
+        }
+        map.push_back(line);
+    }
+    return maps;
+}
 
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
-        return EXIT_FAILURE;
+}  // namespace reference
+
+/*
+ * Summarizes the input's patterns repeated up to n patterns, both with the bitmasks and with
+ * the reference templates, checks that every summary agrees and reports patterns/s for each
+ */
+static bool benchmarkPatterns(string_view input, uint64_t n) {
+    const auto maps = reference::toMaps(input);
+    if (maps.empty()) {
+        return true;
     }
-    const auto toMaps = [&lines]() {
-        std::vector<std::vector<std::string> > maps;
-        std::vector<std::string> map;
-        lines.emplace_back();
-        for (auto& line : lines) {
-            if (line.empty() && !map.empty()) {
-                maps.push_back(map);
-                map.clear();
-                continue;
-            }
-            map.push_back(std::move(line));
+    string text;
+    for (uint64_t i = 0; i < n; ++i) {
+        for (const auto line: maps[i % maps.size()]) {
+            text.append(line).push_back('\n');
         }
-        return maps;
+        text.push_back('\n');
+    }
+    const day13::Patterns patterns(text);
+    const auto many = reference::toMaps(text);
+    if (patterns.size() != many.size()) {
+        cerr << "Only " << patterns.size() << " of " << many.size() << " patterns fit the bitmasks" << endl;
+        return false;
+    }
+
+    const auto rate = [n](auto summarize) {
+        const auto start = chrono::steady_clock::now();
+        summarize();
+        const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        return static_cast<uint64_t>(static_cast<double>(n) / elapsed.count());
     };
-    const auto maps = toMaps();
+    vector<uint32_t> summaries(n);
+    vector<uint32_t> expected(n);
+    cout << "  " << n << " patterns" << endl;
+    for (const unsigned smudges: {0u, 1u}) {
+        const auto bitmasks = rate([&] { day13::summarize(patterns, smudges, summaries); });
+        const auto templates = rate([&] {
+            transform(many.begin(), many.end(), expected.begin(), [smudges](const auto &map) {
+                return static_cast<uint32_t>(0 == smudges ? reference::pattern<0>(map) : reference::pattern<1>(map));
+            });
+        });
+        if (summaries != expected) {
+            cerr << "Summaries with " << smudges << " smudges differ from the reference" << endl;
+            return false;
+        }
+        cout << "    " << smudges << " smudges: " << bitmasks << " patterns/s with bitmasks, " << templates
+             << " with templates" << endl;
+    }
+    return true;
+}
 
-    {
-        // Part 1
-        constexpr size_t targetDiff{0};
-        const auto sum = accumulate(maps.cbegin(), maps.cend(), size_t{}, pattern<targetDiff>);
-        cout << "  Part 1" << endl;
-        cout << "     Sum : " << sum << endl;
+/*
+ * Usage: Day_13 [--bench <n>]
+ * With --bench, also summarizes n patterns repeated from the input and compares the rates.
+ */
+int main(int argc, char *argv[])
+{
+    uint64_t bench{};
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        if ("--bench" == arg && i + 1 < argc) {
+            bench = stoull(argv[++i]);
+        } else {
+            cerr << "Usage: " << argv[0] << " [--bench <n>]" << endl;
+            return EXIT_FAILURE;
+        }
     }
-    {  // Part 2
-        constexpr size_t targetDiff{1};
-        const auto sum = accumulate(maps.cbegin(), maps.cend(), size_t{}, pattern<targetDiff>);
-        cout << "  Part 2" << endl;
-        cout << "     Sum : " << sum << endl;
+
+    cout << "Day 13" << endl;
+
+    const aoc::MappedFile input(day13::file1);
+    if (!input) {
+        return EXIT_FAILURE;
     }
 
+    cout << "  Part 1" << endl;
+    cout << "     Sum : " << day13::solvePart1(input.view()) << endl;
+
+    cout << "  Part 2" << endl;
+    cout << "     Sum : " << day13::solvePart2(input.view()) << endl;
+
+    if (0 != bench && !benchmarkPatterns(input.view(), bench)) {
+        return EXIT_FAILURE;
+    }
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
@@ -30,30 +30,14 @@
 #include <vector>
 #include <cstdint>
 #include <map>
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
 
 using namespace std;
 
-const string file1 = "input.txt";
-
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
-
-    auto closeStream = [&in] {
-        in.close();
-    };
-
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
-    }
+namespace day14 {
 
-    closeStream();
-    return true;
-}
+const string file1 = "input.txt";
 
 static void moveNorth(vector<string> &grid) {
     for (size_t r = 1; r < grid.size(); ++r) {
@@ -119,65 +103,80 @@ static void moveEast(vector<string> &grid) {
     }
 }
 
-int main() {
-
-    cout << "Day 14" << endl;
-
+static vector<string> toGrid(string_view input) {
     vector<string> grid{};
-    if (!readFile(file1, grid)) {
-        return EXIT_FAILURE;
-    }
+    aoc::forEachLine(input, [&grid](string_view line) {
+        grid.emplace_back(line);
+    });
+    return grid;
+}
 
-    const auto load = [](const vector<string> &grid) {
-        uint64_t sum{};
-        for (size_t r = 0; r < grid.size(); ++r) {
-            for (size_t c = 0; c < grid[r].size(); ++c) {
-                if (grid[r][c] == 'O') {
-                    sum += grid.size() - r;
-                }
+static uint64_t load(const vector<string> &grid) {
+    uint64_t sum{};
+    for (size_t r = 0; r < grid.size(); ++r) {
+        for (size_t c = 0; c < grid[r].size(); ++c) {
+            if (grid[r][c] == 'O') {
+                sum += grid.size() - r;
             }
         }
-        return sum;
-    };
+    }
+    return sum;
+}
 
+aoc::Answer solvePart1(string_view input) {
+    auto grid = toGrid(input);
+    moveNorth(grid);
+    return to_string(load(grid));
+}
 
-    {
-        // Part 1
-        moveNorth(grid);
+aoc::Answer solvePart2(string_view input) {
+    auto grid = toGrid(input);
+    moveNorth(grid);
+    moveWest(grid);
+    moveSouth(grid);
+    moveEast(grid);
 
-        const auto sum = load(grid);
-        cout << "  Part 1" << endl;
-        cout << "     Total Load : " << sum << endl;
-    }
-    {  // Part 2
+    size_t step{1};
+
+    map<vector<string>, size_t> cache;
+    cache.insert({grid, step});
+
+    constexpr size_t stop(1000000000);
+    while (step++ < stop) {
+        moveNorth(grid);
         moveWest(grid);
         moveSouth(grid);
         moveEast(grid);
 
-        size_t step{1};
+        if (auto it = cache.find(grid);  it != cache.end()) {
+            const auto period = step - it->second;
+            step = stop - (stop - step) % period;
+            cache.clear();
+        } else if (!cache.empty()) {
+            cache.insert({grid, step});
+        }
+    }
+    return to_string(load(grid));
+}
 
-        map<vector<string>, size_t> cache;
-        cache.insert({grid, step});
+}  // namespace day14
 
-        constexpr size_t stop(1000000000);
-        while (step++ < stop) {
-            moveNorth(grid);
-            moveWest(grid);
-            moveSouth(grid);
-            moveEast(grid);
+#ifndef AOC_LIBRARY
+int main() {
 
-            if (auto it = cache.find(grid);  it != cache.end()) {
-                const auto period = step - it->second;
-                step = stop - (stop - step) % period;
-                cache.clear();
-            } else if (!cache.empty()) {
-                cache.insert({grid, step});
-            }
-        }
-        const auto sum = load(grid);
-        cout << "  Part 2" << endl;
-        cout << "     Total Load : " << sum << endl;
+    cout << "Day 14" << endl;
+
+    const aoc::MappedFile input(day14::file1);
+    if (!input) {
+        return EXIT_FAILURE;
     }
 
+    cout << "  Part 1" << endl;
+    cout << "     Total Load : " << day14::solvePart1(input.view()) << endl;
+
+    cout << "  Part 2" << endl;
+    cout << "     Total Load : " << day14::solvePart2(input.view()) << endl;
+
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
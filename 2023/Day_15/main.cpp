@@ -30,9 +30,13 @@
 #include <utility>
 #include <vector>
 #include <deque>
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
 
 using namespace std;
 
+namespace day15 {
+
 const string file1 = "input.txt";
 
 class Step {
@@ -59,26 +63,6 @@ public:
     }
 };
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
-
-    auto closeStream = [&in] {
-        in.close();
-    };
-
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
-    }
-
-    closeStream();
-    return true;
-}
-
 int hash_alg(const string &step) {
     int cur_val = 0;
     for (char a: step) {
@@ -93,7 +77,7 @@ int hash_alg(const string &step) {
 Step get_parts(const string &step) {
     stringstream s;
     char a;
-    char op;
+    char op{};
     int length = 0;
     string label;
     s << step;
@@ -110,16 +94,8 @@ Step get_parts(const string &step) {
     return new_step;
 }
 
-int main() {
-
-    cout << "Day 15" << endl;
-
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
-        return EXIT_FAILURE;
-    }
-
-    const auto &line = lines[0];
+static vector<string> toSteps(string_view input) {
+    const auto line = aoc::splitLines(input)[0];
 
     vector<string> steps;
     string temp;
@@ -135,14 +111,19 @@ int main() {
 
     temp += line[line.size() - 1];
     steps.push_back(temp);
+    return steps;
+}
 
+aoc::Answer solvePart1(string_view input) {
     int total1 = 0;
-    for (const string &step: steps) {
+    for (const string &step: toSteps(input)) {
         total1 += hash_alg(step);
     }
+    return to_string(total1);
+}
 
-    cout << "  Part 1" << endl;
-    cout << "     Initialize sequence sum  : " << total1 << endl;
+aoc::Answer solvePart2(string_view input) {
+    const auto steps = toSteps(input);
 
     int total2 = 0;
     deque<Lens> boxes[256];
@@ -185,9 +166,27 @@ int main() {
             total2 += (i + 1) * (j + 1) * boxes[i][j].length;
         }
     }
+    return to_string(total2);
+}
+
+}  // namespace day15
+
+#ifndef AOC_LIBRARY
+int main() {
+
+    cout << "Day 15" << endl;
+
+    const aoc::MappedFile input(day15::file1);
+    if (!input) {
+        return EXIT_FAILURE;
+    }
+
+    cout << "  Part 1" << endl;
+    cout << "     Initialize sequence sum  : " << day15::solvePart1(input.view()) << endl;
 
     cout << "  Part 2" << endl;
-    cout << "     Focusing power : " << total2 << endl;
+    cout << "     Focusing power : " << day15::solvePart2(input.view()) << endl;
 
     return 0;
-}
\ No newline at end of file
+}
+#endif
@@ -30,62 +30,57 @@
 #include <vector>
 #include <cstdint>
 #include <array>
-#include <queue>
-#include <unordered_set>
 #include <algorithm>
+#include "../Common/Grid.h"
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
+#include "../Common/Trace.h"
 
 using namespace std;
 
-using Coord = uint8_t;
-using Pos = array<Coord, 2>;
+namespace day16 {
+
 using Dir = uint8_t;
-using Beam = pair<Pos, Dir>;
+using Grid = aoc::Grid<char>;
 
-struct BeamHash {
-    size_t operator()(const Beam &beam) const {
-        return (beam.first[0] << 8) + beam.first[1];
-    }
-};
+constexpr char edge = '\0';  // border ring: a beam reaching it leaves the contraption
 
 const string file1 = "input.txt";
 
-static bool reflect(Beam &beam, const vector<string> &grid) {
-    auto &[pos, dir] = beam;
-    const auto &[r, c] = pos;
-
+static bool reflect(char tile, Dir &dir) {
     if (0 == dir) { // right
-        if ('\\' == grid[r][c]) {
+        if ('\\' == tile) {
             dir = 1;
-        } else if ('/' == grid[r][c]) {
+        } else if ('/' == tile) {
             dir = 3;
-        } else if ('|' == grid[r][c]) {
+        } else if ('|' == tile) {
             dir = 1;
             return true;
         }
     } else if (1 == dir) { // down
-        if ('\\' == grid[r][c]) {
+        if ('\\' == tile) {
             dir = 0;
-        } else if ('/' == grid[r][c]) {
+        } else if ('/' == tile) {
             dir = 2;
-        } else if ('-' == grid[r][c]) {
+        } else if ('-' == tile) {
             dir = 0;
             return true;
         }
     } else if (2 == dir) { // left
-        if ('\\' == grid[r][c]) {
+        if ('\\' == tile) {
             dir = 3;
-        } else if ('/' == grid[r][c]) {
+        } else if ('/' == tile) {
             dir = 1;
-        } else if ('|' == grid[r][c]) {
+        } else if ('|' == tile) {
             dir = 1;
             return true;
         }
     } else if (3 == dir) { // up
-        if ('\\' == grid[r][c]) {
+        if ('\\' == tile) {
             dir = 2;
-        } else if ('/' == grid[r][c]) {
+        } else if ('/' == tile) {
             dir = 0;
-        } else if ('-' == grid[r][c]) {
+        } else if ('-' == tile) {
             dir = 0;
             return true;
         }
@@ -93,114 +88,70 @@ static bool reflect(Beam &beam, const vector<string> &grid) {
     return false;
 }
 
-
-static bool move(Beam &beam, const vector<string> &grid) {
-    auto &[pos, dir] = beam;
-    auto &[r, c] = pos;
-
-    if (0 == dir) { // right
-        if (grid[0].size() - 1 == c) {
-            return false;
-        }
-        c++;
-
-    } else if (1 == dir) { // down
-        if (grid.size() - 1 == r) {
-            return false;
-        }
-        r++;
-    } else if (2 == dir) { // left
-        if (0 == c) {
-            return false;
-        }
-        c--;
-    } else if (3 == dir) { // up
-        if (0 == r) {
-            return false;
-        }
-        r--;
-    }
-    return true;
-}
-
-static uint64_t simulate(const Beam &start, vector<string> &grid) {
-    queue<Beam> beams;
-    beams.push(start);
-    unordered_set<Beam, BeamHash> visited;
+static uint64_t simulate(size_t start, Dir startDir, const Grid &grid) {
+    const auto offsets = grid.offsets();
+    vector<uint8_t> visited(grid.size());  // one bit per direction a beam entered the cell with
+    vector<pair<size_t, Dir> > beams{{start, startDir}};
+    uint64_t energized{};
 
     while (!beams.empty()) {
-        auto beam = beams.front();
-        beams.pop();
-
-        while (visited.find(beam) == visited.end()) {
-            visited.insert(beam);
-            if (reflect(beam, grid)) {
-                const auto &[pos, dir] = beam;
-                beams.emplace(pos, (dir + 2) % 4);
-            }
-
-            if (!move(beam, grid)) {
-                break;
+        auto [i, dir] = beams.back();
+        beams.pop_back();
+
+        while (edge != grid[i] && 0 == (visited[i] & (1U << dir))) {
+            AOC_TRACE_COUNT("day16.steps");
+            energized += 0 == visited[i];
+            visited[i] |= static_cast<uint8_t>(1U << dir);
+            if (reflect(grid[i], dir)) {
+                AOC_TRACE_COUNT("day16.splits");
+                beams.emplace_back(i, (dir + 2) % 4);
             }
+            i += offsets[dir];
         }
     }
+    AOC_TRACE_HISTOGRAM("day16.energized", energized);
+    return energized;
+}
 
-    unordered_set<uint64_t> energized;
-    energized.reserve(visited.size());
-    transform(visited.cbegin(), visited.cend(), inserter(energized, energized.end()),
-              [](const Beam &beam) { return BeamHash{}(beam); });
-    return energized.size();
+aoc::Answer solvePart1(string_view input) {
+    AOC_TRACE_SPAN("day16.part1");
+    const auto grid = Grid::parse(input, edge, [](char c) { return c; });
+    return to_string(simulate(grid.index(0, 0), 0, grid));
 }
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
+aoc::Answer solvePart2(string_view input) {
+    AOC_TRACE_SPAN("day16.part2");
+    const auto grid = Grid::parse(input, edge, [](char c) { return c; });
+    uint64_t maxTiles{};
+    for (size_t r = 1; r < grid.rows(); ++r) {
+        maxTiles = max(maxTiles, simulate(grid.index(r, 0), 0, grid));
+        maxTiles = max(maxTiles, simulate(grid.index(r, grid.cols() - 1), 2, grid));
     }
-
-    auto closeStream = [&in] {
-        in.close();
-    };
-
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
+    for (size_t c = 1; c < grid.rows(); ++c) {
+        maxTiles = max(maxTiles, simulate(grid.index(0, c), 1, grid));
+        maxTiles = max(maxTiles, simulate(grid.index(grid.cols() - 1, c), 3, grid));
     }
-
-    closeStream();
-    return true;
+    return to_string(maxTiles);
 }
 
+}  // namespace day16
+
+#ifndef AOC_LIBRARY
 int main() {
 
     cout << "Day 16" << endl;
 
-    vector<string> grid{};
-    if (!readFile(file1, grid)) {
+    const aoc::MappedFile input(day16::file1);
+    if (!input) {
         return EXIT_FAILURE;
     }
 
-    {
-        // Part 1
-        uint64_t max = simulate({{0, 0}, 0}, grid);
-        cout << "  Part 1" << endl;
-        cout << "     Energized tiles : " << max << endl;
-    }
-    {  // Part 2
-        uint64_t maxTiles{};
-        for (Coord r = 1; r < grid.size(); ++r) {
-            maxTiles = max(maxTiles, simulate({{r, 0}, 0}, grid));
-            maxTiles = max(maxTiles, simulate({{r, static_cast<Coord>(grid[0].size() - 1)}, 2}, grid));
-        }
-        for (Coord c = 1; c < grid.size(); ++c) {
-            maxTiles = max(maxTiles, simulate({{0, c}, 1}, grid));
-            maxTiles = max(maxTiles, simulate({{static_cast<Coord>(grid[0].size() - 1),c}, 3}, grid));
-        }
+    cout << "  Part 1" << endl;
+    cout << "     Energized tiles : " << day16::solvePart1(input.view()) << endl;
 
-        cout << "  Part 2" << endl;
-        cout << "     Max Energized tiles: " << maxTiles << endl;
-    }
+    cout << "  Part 2" << endl;
+    cout << "     Max Energized tiles: " << day16::solvePart2(input.view()) << endl;
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
@@ -28,91 +28,60 @@
 #include <iostream>
 #include <queue>
 #include <string>
-#include <unordered_map>
 #include <vector>
 #include <cstdint>
+#include "../Common/Grid.h"
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
+#include "../Common/Trace.h"
 
 using namespace std;
 
-const string file1 = "input.txt";
-
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
+namespace day17 {
 
-    auto closeStream = [&in] {
-        in.close();
-    };
-
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
-    }
-
-    closeStream();
-    return true;
-}
+const string file1 = "input.txt";
 
-using Pos = array<uint8_t, 2>;
 using Dir = uint8_t;
-using HeatMap = vector<string>;
+using HeatMap = aoc::Grid<uint8_t>;
+
+constexpr uint8_t edge = 0;  // border ring; every block inside loses 1 to 9
 
 struct State
 {
-    State(const Pos& pos, Dir dir, Dir step = 0, uint16_t heat = 0) : pos{pos}, dir{dir}, step{step}, heat{heat}
+    State(uint32_t index, Dir dir, Dir step = 0, uint16_t heat = 0) : index{index}, heat{heat}, dir{dir}, step{step}
     {
     }
-    Pos pos{};
+    uint32_t index{};
     uint16_t heat{};
     Dir dir{};
     Dir step{};
-
-    [[nodiscard]] uint32_t hash() const
-    {
-        uint32_t hash{};
-        hash |= static_cast<uint32_t>(pos[0]);
-        hash |= static_cast<uint32_t>(pos[1]) << 8;
-        hash |= static_cast<uint32_t>(step) << 16;
-        hash |= static_cast<uint32_t>(dir) << 24;
-        return hash;
-    }
 };
 
-static uint16_t dijkstra(const HeatMap& heatmap, const Pos& start, const Pos& end, Dir minStep = 1, Dir maxStep = 3)
+static uint16_t dijkstra(const HeatMap& heatmap, size_t start, size_t end, Dir minStep = 1, Dir maxStep = 3)
 {
-    unordered_map<uint32_t, uint16_t> visited{};
-    constexpr array<array<int8_t, 2>, 4> adjs{{{0, 1}, {1, 0}, {0, -1}, {-1, 0}}};
+    AOC_TRACE_SPAN("day17.dijkstra");
+    // lowest heat seen per block, direction and run length
+    const size_t runs = maxStep + 1;
+    vector<uint16_t> visited(heatmap.size() * 4 * runs, UINT16_MAX);
+    const auto adjs = heatmap.offsets();
     auto cmp = [](const auto& a, const auto& b) { return a.heat > b.heat; };
     priority_queue<State, vector<State>, decltype(cmp)> q(cmp);
     for (Dir dir = 0 ; dir < static_cast<uint8_t>(adjs.size()); dir++) {
-        q.emplace(start, dir);
+        q.emplace(static_cast<uint32_t>(start), dir);
     }
     while (!q.empty()) {
         const auto state = q.top();
-        if (state.pos == end && state.step >= minStep) {
+        if (state.index == end && state.step >= minStep) {
             return state.heat;
         }
         q.pop();
-        const auto [r, c] = state.pos;
+        AOC_TRACE_COUNT("day17.pop");
+        AOC_TRACE_HISTOGRAM("day17.queue", q.size());
+        AOC_TRACE_ADD("day17.stale", state.heat > visited[(state.index * 4 + state.dir) * runs + state.step]);
         for (Dir dir = 0; dir < static_cast<uint8_t >(adjs.size()); ++dir) {
             if (dir == (state.dir + 2) % adjs.size()) {  // must not reverse
                 continue;
             }
-            if (0 == dir && heatmap[0].size() - 1 == c) {  // E
-                continue;
-            }
-            if (1 == dir && heatmap.size() - 1 == r) {  // S
-                continue;
-            }
-            if (2 == dir && 0 == c) {  // W
-                continue;
-            }
-            if (3 == dir && 0 == r) {  // N
-                continue;
-            }
             if (dir != state.dir && state.step < minStep) {  // must move at least min steps in same direction
                 continue;
             }
@@ -120,47 +89,56 @@ static uint16_t dijkstra(const HeatMap& heatmap, const Pos& start, const Pos& en
             if (step > maxStep) {  // must not move more than max steps in same direction
                 continue;
             }
-            const auto& [rr, cc] = adjs[dir];
-            const auto pos = Pos{static_cast<uint8_t>(r + rr), static_cast<uint8_t>(c + cc)}; // grab row and column
-            const auto heat = static_cast<uint16_t>(state.heat + heatmap[pos[0]][pos[1]] - '0'); // convert heat to number
-            const auto next = State{pos, dir, step, heat};
-            const auto hash = next.hash();
-            if (auto it = visited.find(hash); it != visited.end()) {
-                if (heat < it->second) {
-                    it->second = heat;
-                    q.push(next);
-                }
-            } else {
-                visited[hash] = heat;
-                q.push(next);
+            const auto index = static_cast<uint32_t>(state.index + adjs[dir]);
+            if (edge == heatmap[index]) {
+                continue;
+            }
+            const auto heat = static_cast<uint16_t>(state.heat + heatmap[index]);
+            auto &best = visited[(index * 4 + dir) * runs + step];
+            if (heat < best) {
+                AOC_TRACE_COUNT("day17.push");
+                best = heat;
+                q.emplace(index, dir, step, heat);
             }
         }
     }
     return UINT16_MAX;
 }
+
+static HeatMap toHeatMap(string_view input) {
+    return HeatMap::parse(input, edge, [](char c) { return static_cast<uint8_t>(c - '0'); });
+}
+
+aoc::Answer solvePart1(string_view input) {
+    const auto heatmap = toHeatMap(input);
+    const auto end = heatmap.index(heatmap.rows() - 1, heatmap.cols() - 1);
+    return to_string(dijkstra(heatmap, heatmap.index(0, 0), end, 1, 3));
+}
+
+aoc::Answer solvePart2(string_view input) {
+    const auto heatmap = toHeatMap(input);
+    const auto end = heatmap.index(heatmap.rows() - 1, heatmap.cols() - 1);
+    return to_string(dijkstra(heatmap, heatmap.index(0, 0), end, 4, 10));
+}
+
+}  // namespace day17
+
+#ifndef AOC_LIBRARY
 int main()
 {
     cout << "Day 17" << endl;
 
-    vector<string> heatmap{};
-    if (!readFile(file1, heatmap)) {
+    const aoc::MappedFile input(day17::file1);
+    if (!input) {
         return EXIT_FAILURE;
     }
 
-    const auto start = Pos{0, 0};
-    const auto end = Pos{static_cast<uint8_t>(heatmap.size() - 1), static_cast<uint8_t>(heatmap[0].size() - 1)};
+    cout << "  Part 1" << endl;
+    cout << "     Minimal heat loss (1 step min, 3 steps max): " << day17::solvePart1(input.view()) << endl;
 
-    {
-        // Part 1
-        const auto amt = dijkstra(heatmap, start, end, 1, 3);
-        cout << "  Part 1" << endl;
-        cout << "     Minimal heat loss (1 step min, 3 steps max): " << amt << endl;
-    }
-    {  // Part 2
-        const auto amt = dijkstra(heatmap, start, end, 4, 10);
-        cout << "  Part 2" << endl;
-        cout << "     Minimal heat loss (4 steps min, 10 steps max): " << amt << endl;
-    }
+    cout << "  Part 2" << endl;
+    cout << "     Minimal heat loss (4 steps min, 10 steps max): " << day17::solvePart2(input.view()) << endl;
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
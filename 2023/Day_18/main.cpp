@@ -29,9 +29,13 @@
 #include <vector>
 #include <cstdint>
 #include <sstream>
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
 
 using namespace std;
 
+namespace day18 {
+
 const string file1 = "input.txt";
 
 struct dig_t {
@@ -102,30 +106,10 @@ size_t lava_capacity(const digs_t &digs, bool convert) {
     return shoelace(vertices);
 }
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
-
-    auto closeStream = [&in] {
-        in.close();
-    };
-
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
-    }
-
-    closeStream();
-    return true;
-}
-
-digs_t parse(const vector<string> &lines) {
+digs_t parse(string_view input) {
 
     digs_t digs;
-    for (const auto &line: lines) {
+    for (const auto &line: aoc::splitLines(input)) {
         dig_t dig;
         char dir;
 
@@ -156,27 +140,37 @@ digs_t parse(const vector<string> &lines) {
     return digs;
 }
 
+aoc::Answer solvePart1(string_view input) {
+    // stores the parsed information
+    const digs_t digs = parse(input);
+    return to_string(lava_capacity(digs, true));
+}
+
+aoc::Answer solvePart2(string_view input) {
+    const digs_t digs = parse(input);
+    return to_string(lava_capacity(digs, false));
+}
+
+}  // namespace day18
+
+#ifndef AOC_LIBRARY
 int main() {
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
+    const aoc::MappedFile input(day18::file1);
+    if (!input) {
         return EXIT_FAILURE;
     }
 
-    // stores the parsed information
-    digs_t digs = parse(lines);
-
     cout << "Day 18" << endl;
     {
         // Part 1
-        size_t amt = lava_capacity(digs, true);
         cout << "  Part 1" << endl;
-        cout << "     Cubic meters : " << amt << endl;
+        cout << "     Cubic meters : " << day18::solvePart1(input.view()) << endl;
     }
     {  // Part 2
-        size_t amt = lava_capacity(digs, false);
         cout << "  Part 2" << endl;
-        cout << "     Corrected cubic meters : " << amt << endl;
+        cout << "     Corrected cubic meters : " << day18::solvePart2(input.view()) << endl;
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
@@ -34,9 +34,17 @@
 #include <vector>
 #include <array>
 #include <memory>
+#include <memory_resource>
+#include "../Common/Arena.h"
+#include "../Common/Input.h"
+#include "../Common/Parse.h"
+#include "../Common/Solver.h"
+#include "../Common/Trace.h"
 
 using namespace std;
 
+namespace day19 {
+
 using RuleName = string;
 using Index = uint8_t;
 using Target = variant<monostate, RuleName, bool>;
@@ -138,30 +146,10 @@ struct Greater : Rule {
 };
 
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
-
-    auto closeStream = [&in] {
-        in.close();
-    };
-
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
-    }
-
-    closeStream();
-    return true;
-}
-
 
-using Parts = vector<Part>;
-using Rules = vector<shared_ptr<Rule> >;
-using RuleMap = map<RuleName, Rules>;
+using Parts = pmr::vector<Part>;
+using Rules = pmr::vector<shared_ptr<Rule> >;
+using RuleMap = pmr::map<RuleName, Rules>;
 using Range = pair<uint16_t, uint16_t>;
 
 struct RangePart {
@@ -193,9 +181,15 @@ struct RangePart {
     array<Range, 4> items;
 };
 
-static pair<Parts, RuleMap> toPartsRules(const vector<string> &lines) {
-    vector<Part> parts;
-    RuleMap ruleMap;
+// rules and their control blocks live in the arena of the solve
+template<typename R, typename... Args>
+static shared_ptr<Rule> makeRule(pmr::memory_resource *arena, Args &&...args) {
+    return allocate_shared<R>(pmr::polymorphic_allocator<R>(arena), std::forward<Args>(args)...);
+}
+
+static pair<Parts, RuleMap> toPartsRules(const vector<string_view> &lines, pmr::memory_resource *arena) {
+    Parts parts(arena);
+    RuleMap ruleMap(arena);
     bool isParts{false};
     for (const auto &line: lines) {
         if (line.empty()) {
@@ -203,14 +197,17 @@ static pair<Parts, RuleMap> toPartsRules(const vector<string> &lines) {
             continue;
         }
         if (isParts) {
-            uint16_t x, m, a, s;
-            sscanf(line.c_str(), "{x=%hu,m=%hu,a=%hu,s=%hu}", &x, &m, &a, &s);
-            parts.emplace_back(x, m, a, s);
+            array<uint16_t, 4> xmas{};
+            if (aoc::parseIntegers(line, span(xmas)) != xmas.size()) {
+                cerr << "Not a part : " << line << endl;
+                continue;
+            }
+            parts.emplace_back(xmas[0], xmas[1], xmas[2], xmas[3]);
         } else {
             RuleName name;
-            vector<shared_ptr<Rule> > conds;
+            Rules conds(arena);
             bool isCond{false};
-            Index index;
+            Index index{};
             for (size_t i = 0; i < line.size(); ++i) {
                 if ('{' == line[i]) {
                     name = line.substr(0, i);
@@ -254,35 +251,36 @@ static pair<Parts, RuleMap> toPartsRules(const vector<string> &lines) {
                 const auto isR = target == "R";
                 if (isLess) {
                     if (isA) {
-                        conds.emplace_back(make_shared<Less>(index, amt, true));
+                        conds.emplace_back(makeRule<Less>(arena, index, amt, true));
                     } else if (isR) {
-                        conds.emplace_back(make_shared<Less>(index, amt, false));
+                        conds.emplace_back(makeRule<Less>(arena, index, amt, false));
                     } else {
-                        conds.emplace_back(make_shared<Less>(index, amt, target));
+                        conds.emplace_back(makeRule<Less>(arena, index, amt, target));
                     }
                 } else if (isGreater) {
                     if (isA) {
-                        conds.emplace_back(make_shared<Greater>(index, amt, true));
+                        conds.emplace_back(makeRule<Greater>(arena, index, amt, true));
                     } else if (isR) {
-                        conds.emplace_back(make_shared<Greater>(index, amt, false));
+                        conds.emplace_back(makeRule<Greater>(arena, index, amt, false));
                     } else {
-                        conds.emplace_back(make_shared<Greater>(index, amt, target));
+                        conds.emplace_back(makeRule<Greater>(arena, index, amt, target));
                     }
                 } else if (isA) {
-                    conds.emplace_back(make_shared<Accept>());
+                    conds.emplace_back(makeRule<Accept>(arena));
                 } else if (isR) {
-                    conds.emplace_back(make_shared<Reject>());
+                    conds.emplace_back(makeRule<Reject>(arena));
                 } else {
-                    conds.emplace_back(make_shared<Next>(target));
+                    conds.emplace_back(makeRule<Next>(arena, target));
                 }
             }
             ruleMap[name] = std::move(conds);
         }
     }
-    return {parts, ruleMap};
+    return {std::move(parts), std::move(ruleMap)};
 }
 
 static bool validate(const RuleName &ruleName, const RuleMap &ruleMap, const Part &part, size_t ruleIndex = 0) {
+    AOC_TRACE_COUNT("day19.rule.eval");
     const auto &rules = ruleMap.at(ruleName);
     const auto result = rules[ruleIndex]->eval(part);
     if (holds_alternative<RuleName>(result)) {
@@ -295,9 +293,12 @@ static bool validate(const RuleName &ruleName, const RuleMap &ruleMap, const Par
 }
 
 static uint64_t count(const RuleName &ruleName, const RuleMap &ruleMap, const RangePart &part, size_t ruleIndex = 0) {
+    AOC_TRACE_COUNT("day19.count.calls");
     if (!part.isValid()) {
+        AOC_TRACE_COUNT("day19.count.empty");
         return 0;
     }
+    AOC_TRACE_HISTOGRAM("day19.count.rule", ruleIndex);
     const auto &rules = ruleMap.at(ruleName);
     const auto &baseRule = rules[ruleIndex];
     if (RuleType::Accept == baseRule->type) {
@@ -343,31 +344,50 @@ static uint64_t count(const RuleName &ruleName, const RuleMap &ruleMap, const Ra
     return 0;
 }
 
+aoc::Answer solvePart1(string_view input) {
+    AOC_TRACE_SPAN("day19.part1");
+    aoc::Arena arena;
+    const auto &[parts, ruleMap] = toPartsRules(aoc::splitLines(input), &arena);
+
+    uint64_t sum{};
+    for (const auto &part: parts) {
+        if (validate(RuleName{"in"}, ruleMap, part)) {
+            sum += part.sum();
+        }
+    }
+    return to_string(sum);
+}
+
+aoc::Answer solvePart2(string_view input) {
+    AOC_TRACE_SPAN("day19.part2");
+    aoc::Arena arena;
+    const auto &[parts, ruleMap] = toPartsRules(aoc::splitLines(input), &arena);
+
+    constexpr auto range = Range{1, 4001};
+    const auto sum = count(RuleName{"in"}, ruleMap, RangePart{range, range, range, range});
+    return to_string(sum);
+}
+
+}  // namespace day19
+
+#ifndef AOC_LIBRARY
 int main() {
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
+    const aoc::MappedFile input(day19::file1);
+    if (!input) {
         return EXIT_FAILURE;
     }
 
     cout << "Day 19" << endl;
-    const auto &[parts, ruleMap] = toPartsRules(lines);
 
     {  // Part 1
-        uint64_t sum{};
-        for (const auto &part: parts) {
-            if (validate(RuleName{"in"}, ruleMap, part)) {
-                sum += part.sum();
-            }
-        }
         cout << "  Part 1" << endl;
-        cout << "     Total : " << sum << endl;
+        cout << "     Total : " << day19::solvePart1(input.view()) << endl;
     }
     {  // Part 2
-        constexpr auto range = Range{1, 4001};
-        const auto sum = count(RuleName{"in"}, ruleMap, RangePart{range, range, range, range});
         cout << "  Part 2" << endl;
-        cout << "     Total : " << sum << endl;
+        cout << "     Total : " << day19::solvePart2(input.view()) << endl;
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
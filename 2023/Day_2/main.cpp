@@ -24,106 +24,160 @@
 // https://adventofcode.com/2023/day/2
 
 
-#include <fstream>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <string>
 #include <vector>
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
 
 using namespace std;
 
+namespace day2 {
+
 const string file1 = "input1.txt";
 
-const int REDMAX = 12;
-const int GREENMAX = 13;
-const int BLUEMAX = 14;
-
-vector<string> explode(char d, const string& s) {
-    vector<string> v;
-    string buf;
-    for (char i : s)
-    {
-        if (i == d) {
-            v.push_back(move(buf));
-            buf.clear();
-        } else {
-            buf.push_back(i);
+// cubes of each color in the bag; the puzzle's unless given on the command line
+struct Limits {
+    uint64_t red{12};
+    uint64_t green{13};
+    uint64_t blue{14};
+};
+
+struct Totals {
+    uint64_t possible{};  // sum of the ids of the games possible within the limits
+    uint64_t power{};     // sum of the products of the fewest cubes of each color per game
+};
+
+/*
+ * Walks one "Game <id>: <n> <color>, <n> <color>; ..." line once. The colors differ in their
+ * first letter, and a game only needs its largest draw of each color, so the draws are never
+ * split apart.
+ */
+static void analyseGame(string_view line, const Limits &limits, Totals &totals) {
+    const auto colon = line.find(':');
+    if (string_view::npos == colon) {
+        return;
+    }
+    uint64_t id = 0;
+    for (size_t i = 0; i < colon; ++i) {
+        if (static_cast<unsigned>(line[i] - '0') < 10) {
+            id = id * 10 + static_cast<uint64_t>(line[i] - '0');
         }
     }
-    v.push_back(move(buf));
-    if (v.back().empty()) {
-        v.pop_back();
+
+    uint64_t red = 0;
+    uint64_t green = 0;
+    uint64_t blue = 0;
+    uint64_t count = 0;
+    for (size_t i = colon + 1; i < line.size(); ++i) {
+        const auto ch = line[i];
+        if (static_cast<unsigned>(ch - '0') < 10) {
+            count = count * 10 + static_cast<uint64_t>(ch - '0');
+        } else if ('r' == ch || 'g' == ch || 'b' == ch) {
+            auto &most = 'r' == ch ? red : 'g' == ch ? green : blue;
+            most = max(most, count);
+            count = 0;
+            // skip the rest of the color name, whose letters would match again
+            while (i + 1 < line.size() && ' ' != line[i + 1] && ',' != line[i + 1] && ';' != line[i + 1]) {
+                ++i;
+            }
+        }
+    }
+
+    if (red <= limits.red && green <= limits.green && blue <= limits.blue) {
+        totals.possible += id;
     }
-    return v;
+    totals.power += red * green * blue;
 }
 
-int main() {
-    cout << "Day 2\n";
+static Totals analyse(string_view input, const Limits &limits = {}) {
+    Totals totals;
+    aoc::forEachLine(input, [&](string_view line) {
+        analyseGame(line, limits, totals);
+    });
+    return totals;
+}
 
-    ifstream inputFile(file1);
-
-    if (inputFile.is_open()) {
-        string line;
-        int gameTotal = 0;
-        int gameNumber = 1;
-        int gamePower = 0;
-
-        while (getline(inputFile, line)) {
-            line = line.substr(line.find(':') + 2);
-
-            auto games = explode(';', line);
-
-            bool gamePossible = true;
-            int redMin = 0;
-            int greenMin = 0;
-            int blueMin = 0;
-
-            for (const auto& game : games) {
-                auto cubes = explode(',', game);
-
-                for (auto& cube : cubes) {
-                    // eliminate leading space
-                    if (!cube.empty() && cube.front() == ' ') {
-                        cube.erase(cube.begin());
-                    }
-
-                    // grab the number as a string and convert to integer
-                    int count = stoi(cube.substr(0, cube.find(' ')));
-
-                    // check limits for each color
-                    auto color = cube.substr(cube.find(' ') + 1);
-                    if (color == "red") {
-                        if (count > REDMAX) {
-                            gamePossible = false;
-                        }
-                        if (count > redMin) {
-                            redMin = count;
-                        }
-                    } else if (color == "green") {
-                        if (count > GREENMAX) {
-                            gamePossible = false;
-                        }
-                        if (count > greenMin) {
-                            greenMin = count;
-                        }
-                    } else if (color == "blue") {
-                        if (count > BLUEMAX) {
-                            gamePossible = false;
-                        }
-                        if (count > blueMin) {
-                            blueMin = count;
-                        }
-                    }
-                }
-            }
+aoc::Answer solvePart1(string_view input) {
+    return to_string(analyse(input).possible);
+}
 
-            if (gamePossible) {
-                gameTotal += gameNumber;
-            }
-            gamePower += (redMin * blueMin * greenMin);
-            gameNumber++;
+aoc::Answer solvePart2(string_view input) {
+    return to_string(analyse(input).power);
+}
+
+}  // namespace day2
+
+#ifndef AOC_LIBRARY
+/*
+ * day2::analyse for a stream of any length, read through a fixed buffer so memory stays
+ * constant; the buffer only grows for a line longer than itself.
+ */
+static day2::Totals analyse(istream &in, const day2::Limits &limits) {
+    day2::Totals totals;
+    vector<char> buffer(1 << 20);
+    size_t kept = 0;  // start of a line the previous read cut off
+    while (true) {
+        in.read(buffer.data() + kept, static_cast<streamsize>(buffer.size() - kept));
+        const auto filled = kept + static_cast<size_t>(in.gcount());
+        const string_view text(buffer.data(), filled);
+        const bool done = !in;
+        const auto end = done ? filled : text.rfind('\n') + 1;  // npos + 1 == 0 keeps it all
+        aoc::forEachLine(text.substr(0, end), [&](string_view line) {
+            day2::analyseGame(line, limits, totals);
+        });
+        if (done) {
+            return totals;
         }
+        kept = filled - end;
+        memmove(buffer.data(), buffer.data() + end, kept);
+        if (kept == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+    }
+}
 
-        cout << "  Total : " << gameTotal << endl;
-        cout << "  Power : " << gamePower << endl;
+/*
+ * Usage: Day_2 [--red <n>] [--green <n>] [--blue <n>] [-]
+ * With "-" the games are streamed from stdin instead of read from input1.txt, so inputs of
+ * any size run in constant memory.
+ */
+int main(int argc, char *argv[]) {
+    day2::Limits limits;
+    bool fromStdin = false;
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        const auto hasValue = i + 1 < argc;
+        if ("--red" == arg && hasValue) {
+            limits.red = stoull(argv[++i]);
+        } else if ("--green" == arg && hasValue) {
+            limits.green = stoull(argv[++i]);
+        } else if ("--blue" == arg && hasValue) {
+            limits.blue = stoull(argv[++i]);
+        } else if ("-" == arg) {
+            fromStdin = true;
+        } else {
+            cerr << "Usage: " << argv[0] << " [--red <n>] [--green <n>] [--blue <n>] [-]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    cout << "Day 2\n";
+
+    day2::Totals totals;
+    if (fromStdin) {
+        ios::sync_with_stdio(false);
+        totals = analyse(cin, limits);
+    } else {
+        const aoc::MappedFile input(day2::file1);
+        if (!input) {
+            return EXIT_FAILURE;
+        }
+        totals = day2::analyse(input.view(), limits);
     }
+    cout << "  Total : " << totals.possible << endl;
+    cout << "  Power : " << totals.power << endl;
 }
+#endif
@@ -34,9 +34,15 @@
 #include <queue>
 #include <algorithm>
 #include <numeric>
+#include <memory_resource>
+#include "../Common/Arena.h"
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
 
 using namespace std;
 
+namespace day20 {
+
 enum class ModuleType {
     Undefined,
     Broadcast,
@@ -44,45 +50,48 @@ enum class ModuleType {
     Conjunction
 };
 
+// allocator-aware, so the maps inside a module take the arena of the graph holding it
 struct Module {
+    using allocator_type = pmr::polymorphic_allocator<>;
+
+    explicit Module(allocator_type alloc = {}) : cycles{alloc}, inputs{alloc}, outputs{alloc} {
+    }
+
+    Module(const Module &other, allocator_type alloc)
+            : cycle{other.cycle}, cycles{other.cycles, alloc}, state{other.state}, inputs{other.inputs, alloc},
+              outputs{other.outputs, alloc}, type{other.type} {
+    }
+
+    Module(Module &&other, allocator_type alloc)
+            : cycle{other.cycle}, cycles{std::move(other.cycles), alloc}, state{other.state},
+              inputs{std::move(other.inputs), alloc}, outputs{std::move(other.outputs), alloc}, type{other.type} {
+    }
+
+    Module(const Module &other) : Module(other, other.cycles.get_allocator()) {
+    }
+
+    Module(Module &&other) noexcept = default;
+    Module &operator=(const Module &other) = default;
+    Module &operator=(Module &&other) = default;
+
     uint64_t cycle{};
-    map<string, uint64_t> cycles;
+    pmr::map<string, uint64_t> cycles;
     bool state{false};
-    map<string, bool> inputs;
-    vector<string> outputs;
+    pmr::map<string, bool> inputs;
+    pmr::vector<string> outputs;
     ModuleType type{ModuleType::Undefined};
 };
 
 using Count = array<uint64_t, 2>;
-using Graph = map<string, Module>;
+using Graph = pmr::map<string, Module>;
 using Pulse = tuple<string, string, bool>;
 
 const string file1 = "input.txt";
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
-
-    auto closeStream = [&in] {
-        in.close();
-    };
-
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
-    }
-
-    closeStream();
-    return true;
-}
-
-static Count simulate(Graph &g, uint64_t step) {
+static Count simulate(Graph &g, uint64_t step, pmr::memory_resource *pool) {
 
     Count count{1, 0};
-    queue<Pulse> q;
+    queue<Pulse, pmr::deque<Pulse> > q{pmr::deque<Pulse>(pool)};
     {
         const auto &broadcaster = g.at("broadcaster");
         count[0] += broadcaster.outputs.size();
@@ -130,13 +139,13 @@ static Count simulate(Graph &g, uint64_t step) {
     return count;
 }
 
-static Graph toGraph(const vector<string> &lines) {
-    Graph g;
+static Graph toGraph(const vector<string_view> &lines, pmr::memory_resource *arena) {
+    Graph g(arena);
     for (const auto &line: lines) {
         string name, out;
-        vector<string> outputs;
+        pmr::vector<string> outputs(arena);
 
-        istringstream iss(line);
+        istringstream iss{string(line)};
         iss >> name;
         ModuleType type{ModuleType::Undefined};
         if (name == "broadcaster") {
@@ -153,27 +162,16 @@ static Graph toGraph(const vector<string> &lines) {
             if (',' == out[out.size() - 1]) {
                 out = out.substr(0, out.size() - 1);
             }
-            if (auto it = g.find(out); it != g.end()) {
-                it->second.inputs[name] = false;
-                it->second.cycles[name] = 0;
-            } else {
-                auto mod = Module{};
-                mod.inputs[name] = false;
-                mod.cycles[name] = 0;
-                g[out] = mod;
-            }
+            // created on first sight, as an output of another module if need be
+            auto &mod = g[out];
+            mod.inputs[name] = false;
+            mod.cycles[name] = 0;
             outputs.emplace_back(out);
         }
 
-        if (auto it = g.find(name); it != g.end()) {
-            it->second.type = type;
-            it->second.outputs = std::move(outputs);
-        } else {
-            auto mod = Module{};
-            mod.type = type;
-            mod.outputs = std::move(outputs);
-            g[name] = mod;
-        }
+        auto &mod = g[name];
+        mod.type = type;
+        mod.outputs = std::move(outputs);
     }
     return g;
 }
@@ -186,26 +184,42 @@ array<T, N> &operator+=(array<T, N> &lhs, const array<T, N> rhs) {
     return lhs;
 }
 
+aoc::Answer solvePart1(string_view input) {
+    aoc::Arena arena;
+    auto g = toGraph(aoc::splitLines(input), &arena);
+    // the pulse queue drains every step; the pool hands its blocks back to the next one
+    pmr::unsynchronized_pool_resource pool(&arena);
+
+    Count count{0, 0};
+    for (uint64_t step = 1; step <= 1000; ++step) {
+        count += simulate(g, step, &pool);
+    }
+    return to_string(count[0] * count[1]);
+}
+
+// Part 2 is meant to be the LCM of the cycles feeding rx; that has not been finished
+aoc::Answer solvePart2(string_view) {
+    return {};
+}
+
+}  // namespace day20
+
+#ifndef AOC_LIBRARY
 int main() {
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
+    const aoc::MappedFile input(day20::file1);
+    if (!input) {
         return EXIT_FAILURE;
     }
 
-    auto g = toGraph(lines);
-
     {   // Part 1
-        Count count{0, 0};
-        for (uint64_t step = 1; step <= 1000; ++step) {
-            count += simulate(g, step);
-        }
         cout << "  Part 1" << endl;
-        cout << "     Low * High : " << count[0] * count[1] << endl;
+        cout << "     Low * High : " << day20::solvePart1(input.view()) << endl;
     }
     {  // Part 2
         cout << "  Part 2" << endl;
-        cout << "     Use LCM : " << endl;
+        cout << "     Use LCM : " << day20::solvePart2(input.view()) << endl;
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
@@ -33,37 +33,24 @@
 #include <unordered_map>
 #include <vector>
 #include <cstdint>
+#include "../Common/Grid.h"
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
+#include "../Common/Trace.h"
 
 #define PART1_STEPS 64
 #define PART2_STEPS 26501365
 
 using namespace std;
 
-const string file1 = "input.txt";
-
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
-
-    auto closeStream = [&in] {
-        in.close();
-    };
-
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
-    }
+namespace day21 {
 
-    closeStream();
-    return true;
-}
+const string file1 = "input.txt";
 
 using Pos = array<uint8_t, 2>;
 using Dir = size_t;
-using Grid = vector<string>;
+using Grid = vector<string_view>;
+using Garden = aoc::Grid<char>;  // bordered by rocks, so walks never leave it
 
 struct State {
     explicit State(const Pos &pos, uint32_t step = 0, array<int16_t, 2> tile = array<int16_t, 2>{})
@@ -84,63 +71,43 @@ struct State {
     array<int16_t, 2> tile{};
 };
 
-static size_t bfs(const Grid &grid) {
-    unordered_map<uint64_t, uint32_t> visited{};
-    constexpr array<array<int8_t, 2>, 4> adjs{{{0, 1}, {1, 0}, {0, -1}, {-1, 0}}};
-    queue<State> q;
-    const Pos dim{static_cast<uint8_t>(grid.size()), static_cast<uint8_t>(grid[0].size())};
-    for (uint8_t r = dim[0] / 2; r < dim[0]; ++r) {
-        for (uint8_t c = dim[1] / 2; c < dim[1]; ++c) {
-            if ('S' == grid[r][c]) {
-                q.emplace(Pos{r, c});
-                break;
-            }
+static size_t bfs(const Garden &garden) {
+    vector<uint8_t> visited(garden.size());
+    const auto adjs = garden.offsets();
+    queue<pair<size_t, uint32_t> > q;  // flat index, steps taken
+    for (const auto i: garden.interior()) {
+        if ('S' == garden[i]) {
+            q.emplace(i, 0);
+            break;
         }
     }
     size_t count{};
     while (!q.empty()) {
-        const auto state = q.front();
+        const auto [i, steps] = q.front();
         q.pop();
-        const auto step = static_cast<uint32_t>(state.step + 1);
+        const auto step = steps + 1;
         if (step > PART1_STEPS) {
             continue;
         }
-        const auto [r, c] = state.pos;
-        for (Dir dir = 0; dir < adjs.size(); ++dir) {
-            if (0 == dir && grid[0].size() - 1 == c) {  // E
-                continue;
-            }
-            if (1 == dir && grid.size() - 1 == r) {  // S
-                continue;
-            }
-            if (2 == dir && 0 == c) {  // W
-                continue;
-            }
-            if (3 == dir && 0 == r) {  // N
-                continue;
-            }
-            const auto &[rr, cc] = adjs[dir];
-            const auto pos = Pos{static_cast<uint8_t>(r + rr), static_cast<uint8_t>(c + cc)};
-            if ('#' == grid[pos[0]][pos[1]]) {
-                continue;
-            }
-            const auto next = State{pos, step};
-            const auto hash = next.hash();
-            if (visited.find(hash) != visited.end()) {
+        for (const auto adj: adjs) {
+            const auto next = i + adj;
+            if ('#' == garden[next] || visited[next]) {
                 continue;
             }
-            const auto rem = PART1_STEPS - next.step;
+            const auto rem = PART1_STEPS - step;
             if (0 == rem % 2) {
                 count++;
             }
-            visited[hash] = next.step;
-            q.push(next);
+            AOC_TRACE_COUNT("day21.bfs.visit");
+            visited[next] = 1;
+            q.emplace(next, step);
         }
     }
     return count;
 }
 
 static int64_t bfsInf(const Grid &grid, uint32_t maxSteps) {
+    AOC_TRACE_SPAN("day21.bfsInf");
     unordered_map<uint64_t, uint32_t> visited{};
     constexpr array<array<int8_t, 2>, 4> adjs{{{0, 1}, {1, 0}, {0, -1}, {-1, 0}}};
     queue<State> q;
@@ -193,10 +160,12 @@ static int64_t bfsInf(const Grid &grid, uint32_t maxSteps) {
             if (0 == rem % 2) {
                 count++;
             }
+            AOC_TRACE_COUNT("day21.bfsInf.visit");
             visited[hash] = next.step;
             q.push(next);
         }
     }
+    AOC_TRACE_HISTOGRAM("day21.bfsInf.tiles", visited.size());
     return count;
 }
 
@@ -205,27 +174,42 @@ int64_t evalQuadratic(int64_t x1, int64_t y1, int64_t x2, int64_t y2, int64_t x3
            ((x - x1) * (x - x2) / ((x3 - x1) * (x3 - x2))) * y3;
 }
 
+aoc::Answer solvePart1(string_view input) {
+    AOC_TRACE_SPAN("day21.part1");
+    const auto garden = Garden::parse(input, '#', [](char c) { return c; });
+    return to_string(bfs(garden));
+}
+
+aoc::Answer solvePart2(string_view input) {
+    AOC_TRACE_SPAN("day21.part2");
+    const Grid grid = aoc::splitLines(input);
+    constexpr uint64_t dim = 131;
+    const auto amt = evalQuadratic(0, bfsInf(grid, (PART1_STEPS + 1) + 0 * dim), 1,
+                                   bfsInf(grid, (PART1_STEPS + 1) + 1 * dim), 2,
+                                   bfsInf(grid, (PART1_STEPS + 1) + 2 * dim),
+                                   (PART2_STEPS - (PART1_STEPS + 1)) / dim);
+    return to_string(amt);
+}
+
+}  // namespace day21
+
+#ifndef AOC_LIBRARY
 int main() {
-    vector<string> grid{};
-    if (!readFile(file1, grid)) {
+    const aoc::MappedFile input(day21::file1);
+    if (!input) {
         return EXIT_FAILURE;
     }
 
     {
         // Part 1
-        const auto amt = bfs(grid);
         cout << "  Part 1" << endl;
-        cout << "     Plots reached in " << PART1_STEPS << " steps : " << amt << endl;
+        cout << "     Plots reached in " << PART1_STEPS << " steps : " << day21::solvePart1(input.view()) << endl;
     }
     {  // Part 2
-        constexpr uint64_t dim = 131;
-        const auto amt = evalQuadratic(0, bfsInf(grid, (PART1_STEPS + 1) + 0 * dim), 1,
-                                       bfsInf(grid, (PART1_STEPS + 1) + 1 * dim), 2,
-                                       bfsInf(grid, (PART1_STEPS + 1) + 2 * dim),
-                                       (PART2_STEPS - (PART1_STEPS + 1)) / dim);
         cout << "  Part 2" << endl;
-        cout << "     Plots reached in " << PART2_STEPS << " steps : " << amt << endl;
+        cout << "     Plots reached in " << PART2_STEPS << " steps : " << day21::solvePart2(input.view()) << endl;
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
@@ -32,10 +32,15 @@
 #include <cstdint>
 #include <unordered_set>
 #include <unordered_map>
-#include <sstream>
+#include "../Common/Input.h"
+#include "../Common/Parse.h"
+#include "../Common/Solver.h"
+#include "../Common/Trace.h"
 
 using namespace std;
 
+namespace day22 {
+
 using Cube = array<uint16_t, 3>;
 using Brick = array<Cube, 2>;
 using Bricks = vector<Brick>;
@@ -50,6 +55,7 @@ static bool overlap(const Brick &a, const Brick &b) {
 
 struct Jenga {
     Jenga(Bricks _bricks, uint16_t minZ) : bricks{std::move(_bricks)} {
+        AOC_TRACE_SPAN("day22.build");
         // Move to the ground
         for (auto &b: bricks) {
             b[0][2] -= minZ;
@@ -64,6 +70,7 @@ struct Jenga {
                 if (!overlap(a, b)) {
                     continue;
                 }
+                AOC_TRACE_COUNT("day22.overlaps");
                 if (a[1][2] <= b[0][2]) {
                     above[i].insert(j);
                     below[j].insert(i);
@@ -112,6 +119,7 @@ struct Jenga {
 
         bool moved;
         do {
+            AOC_TRACE_COUNT("day22.settle.passes");
             moved = false;
             for (int i = 0; i < bricks.size(); ++i) {
                 auto &b = bricks_copy[i];
@@ -141,6 +149,7 @@ struct Jenga {
                 }
             }
         } while (moved);
+        AOC_TRACE_HISTOGRAM("day22.falling", movers.size());
         return movers.size();
     }
 
@@ -196,65 +205,61 @@ private:
     unordered_map<uint16_t, IndexSet> below;
 };
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
 
-    auto closeStream = [&in] {
-        in.close();
-    };
+static pair<Bricks, uint16_t> toBricks(string_view input) {
+    Bricks bricks{};
+    uint16_t minZ(UINT16_MAX);
+    aoc::forEachLine(input, [&](string_view line) {
+        array<uint16_t, 6> vs{};
+        if (aoc::parseIntegers(line, span(vs)) != vs.size()) {
+            cerr << "Not a brick : " << line << endl;
+            return;
+        }
+        Brick b;
+        for (uint16_t i = 0; i < 2; ++i) {
+            for (uint16_t j = 0; j < 3; ++j) {
+                b[i][j] = vs[i * 3 + j] + i;
+            }
+            minZ = min(minZ, b[i][2]);
+        }
+        bricks.emplace_back(b);
+    });
+    return {bricks, minZ};
+}
 
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
-    }
+aoc::Answer solvePart1(string_view input) {
+    AOC_TRACE_SPAN("day22.part1");
+    const auto &[bricks, minZ] = toBricks(input);
+    const auto jenga = Jenga(bricks, minZ);
+    return to_string(jenga.disintegrable().size());
+}
 
-    closeStream();
-    return true;
+aoc::Answer solvePart2(string_view input) {
+    AOC_TRACE_SPAN("day22.part2");
+    const auto &[bricks, minZ] = toBricks(input);
+    const auto jenga = Jenga(bricks, minZ);
+    return to_string(jenga.countFalling());
 }
 
+}  // namespace day22
 
+#ifndef AOC_LIBRARY
 int main() {
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
+    const aoc::MappedFile input(day22::file1);
+    if (!input) {
         return EXIT_FAILURE;
     }
 
-    const auto toBricks = [](const auto &lines) -> pair<Bricks, uint64_t> {
-        Bricks bricks{};
-        uint16_t minZ(UINT16_MAX);
-        for (const auto &line: lines) {
-            istringstream iss(line);
-            Brick b;
-            for (uint16_t i = 0; i < 2; ++i) {
-                for (uint16_t j = 0; j < 3; ++j) {
-                    uint16_t v;
-                    iss >> v;
-                    iss.ignore(1);
-                    b[i][j] = v + i;
-                }
-                minZ = min(minZ, b[i][2]);
-            }
-            bricks.emplace_back(b);
-        }
-        return {bricks, minZ};
-    };
-
-    const auto &[bricks, minZ] = toBricks(lines);
-    const auto jenga = Jenga(bricks, minZ);
-
     {
         // Part 1
         cout << "  Part 1" << endl;
-        cout << "     Blocks that can be disintegrated : " << jenga.disintegrable().size() << endl;
+        cout << "     Blocks that can be disintegrated : " << day22::solvePart1(input.view()) << endl;
     }
     {  // Part 2
         cout << "  Part 2" << endl;
-        cout << "     Sum of other bricks that can fall : " << jenga.countFalling() << endl;
+        cout << "     Sum of other bricks that can fall : " << day22::solvePart2(input.view()) << endl;
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
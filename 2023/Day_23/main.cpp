@@ -27,62 +27,73 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory_resource>
 #include <queue>
 #include <set>
 #include <string>
 #include <vector>
-#include <chrono>
+#include "../Common/Arena.h"
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
+#include "../Common/Trace.h"
 
 using namespace std;
 
+namespace day23 {
+
 const string file1 = "input.txt";
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
+using Pos = array<uint8_t, 2>;
+using Grid = vector<string_view>;
+constexpr array<array<int8_t, 2>, 4> adjs{{{0, 1}, {1, 0}, {0, -1}, {-1, 0}}};
 
-    auto closeStream = [&in] {
-        in.close();
-    };
+// allocator-aware, so copies of a path stay in the pool of the solve
+struct State {
+    using allocator_type = pmr::polymorphic_allocator<>;
 
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
+    State(const Pos &pos, allocator_type alloc) : pos{pos}, path{alloc} {
     }
 
-    closeStream();
-    return true;
-}
+    State(const Pos &pos, const pmr::set<Pos> &_path) : pos{pos}, path{_path, _path.get_allocator()} {
+        AOC_TRACE_COUNT("day23.path.copy");
+        AOC_TRACE_HISTOGRAM("day23.path.size", _path.size());
+        path.insert(pos);
+    }
 
-using Pos = array<uint8_t, 2>;
-using Grid = vector<string>;
-constexpr array<array<int8_t, 2>, 4> adjs{{{0, 1}, {1, 0}, {0, -1}, {-1, 0}}};
+    State(const State &other, allocator_type alloc)
+            : pos{other.pos}, path{other.path, alloc}, dist{other.dist}, prev{other.prev}, branched{other.branched} {
+    }
 
-struct State {
-    explicit State(const Pos &pos) : pos{pos} {
+    State(State &&other, allocator_type alloc)
+            : pos{other.pos}, path{std::move(other.path), alloc}, dist{other.dist}, prev{other.prev},
+              branched{other.branched} {
     }
 
-    State(const Pos &pos, const set<Pos> &_path) : pos{pos}, path{_path} {
-        path.insert(pos);
+    State(const State &other) : State(other, other.path.get_allocator()) {
     }
 
+    State(State &&other) noexcept = default;
+    State &operator=(const State &other) = default;
+    State &operator=(State &&other) = default;
+
     Pos pos{0, 0};
-    set<Pos> path{};
+    pmr::set<Pos> path;
     size_t dist{};
     Pos prev{0, 0};
     bool branched{false};
 };
 
 struct Graph {
+    explicit Graph(pmr::memory_resource *pool) : nodes{pool}, edges{pool} {
+    }
+
     Pos root{};
-    set<Pos> nodes;
-    map<Pos, set<pair<Pos, size_t> > > edges;
+    pmr::set<Pos> nodes;
+    pmr::map<Pos, pmr::set<pair<Pos, size_t> > > edges;
 };
 
-static size_t longest_path(const Grid &grid, const Pos &start, const Pos &end) {
+static size_t longest_path(const Grid &grid, const Pos &start, const Pos &end, pmr::memory_resource *pool) {
+    AOC_TRACE_SPAN("day23.longest_path");
     const auto isNode = [&](const Pos &pos) {
         if ((pos[0] == start[0] && pos[1] == start[1]) || (pos[0] == end[0] && pos[1] == end[1])) {
             return true;
@@ -99,13 +110,13 @@ static size_t longest_path(const Grid &grid, const Pos &start, const Pos &end) {
         return count > 2 && '#' != grid[r][c];
     };
 
-    map<pair<Pos, uint8_t>, size_t> visited;
+    pmr::map<pair<Pos, uint8_t>, size_t> visited(pool);
     visited[{start, 1}] = 0;
-    queue<State> q{};
-    auto first = State{start};
+    queue<State, pmr::deque<State> > q{pmr::deque<State>(pool)};
+    auto first = State{start, pool};
     first.prev = start;
     q.push(first);
-    Graph g;
+    Graph g(pool);
     g.root = start;
     const auto updateQ = [&](const State &next, uint8_t dir) {
         if (auto it = visited.find({next.pos, dir}); it != visited.end()) {
@@ -147,7 +158,9 @@ static size_t longest_path(const Grid &grid, const Pos &start, const Pos &end) {
             if (state.path.find(pos) != state.path.end()) {
                 continue;
             }
-            auto next = State{pos};
+            AOC_TRACE_COUNT("day23.path.copy");
+            AOC_TRACE_HISTOGRAM("day23.path.size", state.path.size());
+            auto next = State{pos, pool};
             next.path = state.path;
             next.path.insert(state.pos);
             next.branched = branched;
@@ -163,7 +176,7 @@ static size_t longest_path(const Grid &grid, const Pos &start, const Pos &end) {
     }
 
     auto cmp = [](const auto &a, const auto &b) { return a.dist < b.dist; };
-    priority_queue<State, vector<State>, decltype(cmp)> q2(cmp);
+    priority_queue<State, pmr::vector<State>, decltype(cmp)> q2(cmp, pmr::vector<State>(pool));
     visited.clear();
     q2.emplace(g.root);
     visited[{g.root, 0}] = 0;
@@ -181,12 +194,15 @@ static size_t longest_path(const Grid &grid, const Pos &start, const Pos &end) {
     while (!q2.empty()) {
         const auto state = q2.top();
         q2.pop();
+        AOC_TRACE_HISTOGRAM("day23.search.queue", q2.size());
         const auto &dsts = g.edges.at(state.pos);
         for (const auto &[pos, w]: dsts) {
             if (state.path.find(pos) != state.path.end()) {
                 continue;
             }
-            auto next = State{pos};
+            AOC_TRACE_COUNT("day23.path.copy");
+            AOC_TRACE_HISTOGRAM("day23.path.size", state.path.size());
+            auto next = State{pos, pool};
             next.path = state.path;
             next.path.insert(state.pos);
             next.dist = state.dist + w;
@@ -196,12 +212,13 @@ static size_t longest_path(const Grid &grid, const Pos &start, const Pos &end) {
     return visited.at({end, 0});
 }
 
-static size_t dijkstra_dag(const Grid &grid, const Pos &start, const Pos &end) {
-    map<Pos, size_t> visited;
+static size_t dijkstra_dag(const Grid &grid, const Pos &start, const Pos &end, pmr::memory_resource *pool) {
+    AOC_TRACE_SPAN("day23.dijkstra_dag");
+    pmr::map<Pos, size_t> visited(pool);
     visited[start] = 0;
     auto cmp = [](const auto &a, const auto &b) { return a.path.size() < b.path.size(); };
-    priority_queue<State, vector<State>, decltype(cmp)> q(cmp);
-    auto first = State{start};
+    priority_queue<State, pmr::vector<State>, decltype(cmp)> q(cmp, pmr::vector<State>(pool));
+    auto first = State{start, pool};
     q.push(first);
     const auto updateQ = [&](const State &next) {
         if (auto it = visited.find(next.pos); it != visited.end()) {
@@ -253,36 +270,43 @@ static size_t dijkstra_dag(const Grid &grid, const Pos &start, const Pos &end) {
     return visited.at(end);
 }
 
-int main() {
-    vector<string> grid{};
-    if (!readFile(file1, grid)) {
-        return EXIT_FAILURE;
-    }
+aoc::Answer solvePart1(string_view input) {
+    const Grid grid = aoc::splitLines(input);
+    const auto start = Pos{0, 1};
+    const auto end = Pos{static_cast<uint8_t>(grid.size() - 1), static_cast<uint8_t>(grid[0].size() - 2)};
+    // paths are copied and dropped all the time; the pool recycles their nodes
+    aoc::Arena arena;
+    pmr::unsynchronized_pool_resource pool(&arena);
+    return to_string(dijkstra_dag(grid, start, end, &pool));
+}
 
+aoc::Answer solvePart2(string_view input) {
+    const Grid grid = aoc::splitLines(input);
     const auto start = Pos{0, 1};
     const auto end = Pos{static_cast<uint8_t>(grid.size() - 1), static_cast<uint8_t>(grid[0].size() - 2)};
+    aoc::Arena arena;
+    pmr::unsynchronized_pool_resource pool(&arena);
+    return to_string(longest_path(grid, start, end, &pool));
+}
 
-    chrono::time_point<std::chrono::system_clock> startTime, endTime;
+}  // namespace day23
+
+#ifndef AOC_LIBRARY
+int main() {
+    const aoc::MappedFile input(day23::file1);
+    if (!input) {
+        return EXIT_FAILURE;
+    }
 
     {
         // Part 1
-        startTime = chrono::system_clock::now();
-        const auto steps = dijkstra_dag(grid, start, end);
-        endTime = std::chrono::system_clock::now();
-        chrono::duration<double> elapsed_seconds = endTime - startTime;
-
         cout << "  Part 1" << endl;
-        cout << "     Steps in Longest Hike : " << steps << endl;
-        cout << "     Elapsed time : " << elapsed_seconds.count() << "s" << endl;
+        cout << "     Steps in Longest Hike : " << day23::solvePart1(input.view()) << endl;
     }
     {  // Part 2
-        startTime = chrono::system_clock::now();
-        const auto steps = longest_path(grid, start, end);
-        endTime = std::chrono::system_clock::now();
-        chrono::duration<double> elapsed_seconds = endTime - startTime;
         cout << "  Part 2" << endl;
-        cout << "     Steps in Longest Hike with no slips: " << steps << endl;
-        cout << "     Elapsed time : " << elapsed_seconds.count() << "s" << endl;
+        cout << "     Steps in Longest Hike with no slips: " << day23::solvePart2(input.view()) << endl;
     }
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
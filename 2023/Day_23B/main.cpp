@@ -29,12 +29,14 @@
 #include <vector>
 #include <array>
 #include <set>
-#include <format>
 #include <algorithm>
-#include <chrono>
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
 
 using namespace std;
 
+namespace day23b {
+
 const string file1 = "input.txt";
 
 #define ALL(x) (x).begin(),(x).end()
@@ -85,22 +87,20 @@ struct PathLength {
     }
 };
 
-int main() {
-
-    ifstream in(file1);
-    if (!in) {
-        cout << format("Could not open inputFilename {}\n", file1);
-        return EXIT_FAILURE;
+static vector<string> toMap(string_view input) {
+    vector<string> map;
+    for (const auto &line: aoc::splitLines(input)) {
+        if (!line.empty()) {
+            map.emplace_back(line);
+        }
     }
+    return map;
+}
 
-    chrono::time_point<std::chrono::system_clock> startTime, endTime;
-
-    string line;
-    vector<string> map;
-    while (in >> line)
-        map.emplace_back(std::move(line));
+aoc::Answer solvePart1(string_view input) {
+    const auto map = toMap(input);
 
-    vector<PathLength> pathSegments, bothDir;
+    vector<PathLength> pathSegments;
     Point startPoint(0, 1), targetPoint(static_cast<int>(map.size() - 1), static_cast<int>(map.front().size() - 2));
     set<Point> toEval = {startPoint};
 
@@ -162,8 +162,15 @@ int main() {
         return maxSubCost;
     });
 
-    startTime = chrono::system_clock::now();
-    int part1 = FindLongest(startPoint), part2 = 0;
+    return to_string(FindLongest(startPoint));
+}
+
+aoc::Answer solvePart2(string_view input) {
+    const auto map = toMap(input);
+
+    vector<PathLength> bothDir;
+    Point startPoint(0, 1), targetPoint(static_cast<int>(map.size() - 1), static_cast<int>(map.front().size() - 2));
+    int part2 = 0;
 
     auto IsSlope = [&](const Point &p) {
         char c = map[p.x][p.y];
@@ -230,16 +237,25 @@ int main() {
         }
     })(path, 0);
 
-    endTime = std::chrono::system_clock::now();
-    chrono::duration<double>elapsed_seconds = endTime - startTime;
+    return to_string(part2);
+}
+
+}  // namespace day23b
+
+#ifndef AOC_LIBRARY
+int main() {
+
+    const aoc::MappedFile input(day23b::file1);
+    if (!input) {
+        return EXIT_FAILURE;
+    }
 
     cout << "  Part 1" << endl;
-    cout << "     Steps in Longest Hike : " << part1 << endl;
+    cout << "     Steps in Longest Hike : " << day23b::solvePart1(input.view()) << endl;
 
     cout << "  Part 2" << endl;
-    cout << "     Steps in Longest Hike with no slips: " << part2 << endl;
-
-    cout << "Elapsed time : " << elapsed_seconds.count() << "s" << endl;
+    cout << "     Steps in Longest Hike with no slips: " << day23b::solvePart2(input.view()) << endl;
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
@@ -23,38 +23,22 @@
 // Advent of Code Day 23
 // https://adventofcode.com/2023/day/23
 
+#include <array>
 #include <fstream>
 #include <iostream>
 #include <optional>
-#include <sstream>
 #include <string>
 #include <type_traits>
 #include <vector>
-#include <chrono>
+#include "../Common/Input.h"
+#include "../Common/Parse.h"
+#include "../Common/Solver.h"
 
 using namespace std;
 
-const string file1 = "input.txt";
-
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
-
-    auto closeStream = [&in] {
-        in.close();
-    };
-
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
-    }
+namespace day24 {
 
-    closeStream();
-    return true;
-}
+const string file1 = "input.txt";
 
 using V = array<int64_t, 3>;
 using Line = array<V, 2>;
@@ -90,8 +74,10 @@ static optional<array<INTERSECT_TYPE, 2> > intersect(const Line &a, const Line &
             }
         }
         s = nom1 / static_cast<INTERSECT_TYPE>(den1 - den2);
-        const auto nom2 = (p2[0] - p1[0]) + s * v2[0];
-        t = nom2 / static_cast<INTERSECT_TYPE>(v1[0]);
+        // v1 cannot be still on both axes here, or the lines would have been parallel
+        const size_t axis = 0 != v1[0] ? 0 : 1;
+        const auto nom2 = (p2[axis] - p1[axis]) + s * v2[axis];
+        t = nom2 / static_cast<INTERSECT_TYPE>(v1[axis]);
     }
     return array<INTERSECT_TYPE, 2>{t, s};
 }
@@ -179,7 +165,7 @@ static V findRock(const Lines &lines) {
                     const auto &vi = lines[0][1] - v;
                     const auto &pj = lines[1][0];
                     const auto &vj = lines[1][1] - v;
-                    const auto &[t, s] = intersect<int64_t>({pi, vi}, {pj, vj}).value();
+                    const auto [t, s] = intersect<int64_t>({pi, vi}, {pj, vj}).value();
                     return V{pi[0] + t * vi[0], pi[1] + t * vi[1], pi[2] + t * vi[2]};
                 }
             }
@@ -188,48 +174,50 @@ static V findRock(const Lines &lines) {
     return V{0, 0, 0};
 }
 
-int main(int argc, char *argv[]) {
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
+static Lines toLines(string_view input) {
+    Lines ls;
+    aoc::forEachLine(input, [&ls](string_view line) {
+        array<int64_t, 6> xs{};
+        if (aoc::parseIntegers(line, span(xs)) != xs.size()) {
+            cerr << "Not a hailstone : " << line << endl;
+            return;
+        }
+        ls.push_back({V{xs[0], xs[1], xs[2]}, V{xs[3], xs[4], xs[5]}});
+    });
+    return ls;
+}
+
+aoc::Answer solvePart1(string_view input) {
+    const auto ls = toLines(input);
+    return to_string(countIntersect<double>(ls, 200000000000000, 400000000000000));
+}
+
+aoc::Answer solvePart2(string_view input) {
+    const auto ls = toLines(input);
+    const auto rock = findRock(ls);
+    return to_string(rock[0] + rock[1] + rock[2]);
+}
+
+}  // namespace day24
+
+#ifndef AOC_LIBRARY
+int main() {
+    const aoc::MappedFile input(day24::file1);
+    if (!input) {
         return EXIT_FAILURE;
     }
 
-    Lines ls;
-    chrono::time_point<chrono::system_clock> startTime, endTime;
-
     {  // Part 1
-        for (const auto &line: lines) {
-            Line l;
-            istringstream iss{line};
-            for (uint8_t i = 0; i < 2; ++i) {
-                for (uint8_t j = 0; j < 3; ++j) {
-                    int64_t x;
-                    iss >> x;
-                    l[i][j] = x;
-                    iss.ignore(1);
-                }
-                iss.ignore(2);
-            }
-            ls.push_back(l);
-        }
         cout << "  Part 1" << endl;
-        startTime = chrono::system_clock::now();
-        const auto count = countIntersect<double>(ls, 200000000000000, 400000000000000);
-        endTime = chrono::system_clock::now();
-        chrono::duration<double> elapsed_seconds = endTime - startTime;
-        cout << "     Intersections in test area : " << count << endl;
-        cout << "     Elapsed time : " << elapsed_seconds.count() << "s" << endl;
+        cout << "     Intersections in test area : " << day24::solvePart1(input.view()) << endl;
     }
     {  // Part 2
         cout << "  Part 2" << endl;
-        startTime = chrono::system_clock::now();
-        const auto rock = findRock(ls);
-        endTime = chrono::system_clock::now();
-        chrono::duration<double> elapsed_seconds = endTime - startTime;
+        const auto rock = day24::findRock(day24::toLines(input.view()));
         cout << "     Coordinates : [" << rock[0] << "," << rock[1] << "," << rock[2] << "]" << endl;
-        cout << "             Sum :  " << rock[0] + rock[1] + rock[2] << endl;
-        cout << "     Elapsed time : " << elapsed_seconds.count() << "s" << endl;
+        cout << "             Sum :  " << day24::solvePart2(input.view()) << endl;
     }
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
@@ -29,42 +29,25 @@
 #include <map>
 #include <string>
 #include <vector>
-#include <chrono>
+#include <algorithm>
+#include <climits>
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
+#include "../Common/Trace.h"
 
 using namespace std;
 
-const string file1 = "input.txt";
-
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
+namespace day25 {
 
-    auto closeStream = [&in] {
-        in.close();
-    };
-
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
-    }
-
-    closeStream();
-    return true;
-}
+const string file1 = "input.txt";
 
 using Matrix = vector<pair<int, int>>;
 using Names = map<string, int>;
 using Edges = vector<vector<int>>;
-Matrix m;  // adjacency matrix
-
-Names names;    // nodes
-Edges edges;    // edges
 
 pair<int, vector<int>> globalMinCut(vector<vector<int>> mat)
 {
+    AOC_TRACE_SPAN("day25.globalMinCut");
     pair<int, vector<int>> best = {INT_MAX, {}};
     size_t n = mat.size();
     vector<vector<int>> co(n);
@@ -78,11 +61,13 @@ pair<int, vector<int>> globalMinCut(vector<vector<int>> mat)
         size_t s = 0, t = 0;
         for (int it = 0; it < n - ph; it++)
         { // O(V^2) -> O(E log V) with prio. queue
+            AOC_TRACE_ADD("day25.relaxations", n);
             w[t] = INT_MIN;
             s = t, t = max_element(w.begin(), w.end()) - w.begin();
             for (int i = 0; i < n; i++)
                 w[i] += mat[t][i];
         }
+        AOC_TRACE_HISTOGRAM("day25.phase.cut", w[t] - mat[t][t]);
         best = min(best, {w[t] - mat[t][t], co[t]});
         co[s].insert(co[s].end(), co[t].begin(), co[t].end());
         for (int i = 0; i < n; i++)
@@ -112,7 +97,7 @@ auto split(const string& s, const string& delimiter) -> vector<string> {
     return result;
 }
 
-auto getIndex(const string &name) {
+auto getIndex(Names &names, const string &name) {
     if (names.find(name) != names.end()) {
         return names[name];
     }
@@ -121,14 +106,16 @@ auto getIndex(const string &name) {
     return index;
 }
 
-Edges parse(vector<string> &lines) {
-    for (const auto &line: lines) {
-        vector<string> tokens = split(line, " ");
+Edges parse(string_view input, Names &names) {
+    Matrix m;  // adjacency matrix
+
+    for (const auto &line: aoc::splitLines(input)) {
+        vector<string> tokens = split(string(line), " ");
         tokens[0] = tokens[0].substr(0, tokens[0].size() - 1);
-        int index = getIndex(tokens[0]);
+        int index = getIndex(names, tokens[0]);
 
         for (size_t i = 1; i < tokens.size(); ++i) {
-            m.emplace_back(index, getIndex(tokens[i]));
+            m.emplace_back(index, getIndex(names, tokens[i]));
         }
     }
     // Initializing a single row
@@ -143,26 +130,34 @@ Edges parse(vector<string> &lines) {
     return edg;
 }
 
+aoc::Answer solvePart1(string_view input) {
+    AOC_TRACE_SPAN("day25.part1");
+    Names names;    // nodes
+    const Edges edges = parse(input, names);    // edges
+    pair<int, vector<int>> ret = globalMinCut(edges);
+    size_t sol = ret.second.size() * (names.size() - ret.second.size());
+    return to_string(sol);
+}
+
+// Day 25 has no second puzzle
+aoc::Answer solvePart2(string_view) {
+    return {};
+}
+
+}  // namespace day25
+
+#ifndef AOC_LIBRARY
 int main() {
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
+    const aoc::MappedFile input(day25::file1);
+    if (!input) {
         return EXIT_FAILURE;
     }
 
-    chrono::time_point<std::chrono::system_clock> startTime, endTime;
-
     {
         // Part 1
         cout << "  Part 1" << endl;
-        startTime = chrono::system_clock::now();
-        edges = parse(lines);
-        pair<int, vector<int>> ret = globalMinCut(edges);
-        size_t sol = ret.second.size() * (names.size() - ret.second.size());
-        endTime = std::chrono::system_clock::now();
-        chrono::duration<double> elapsed_seconds = endTime - startTime;
-
-        cout << "     Two groups multiplied : " << sol << endl;
-        cout << "     Elapsed time : " << elapsed_seconds.count() << "s" << endl;
+        cout << "     Two groups multiplied : " << day25::solvePart1(input.view()) << endl;
     }
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
@@ -24,132 +24,174 @@
 // https://adventofcode.com/2023/day/3
 
 
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
-#include <sstream>
-#include <map>
 #include <vector>
-#include <array>
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
+#include "../Common/ThreadPool.h"
 
 using namespace std;
 
+namespace day3 {
+
 const string file1 = "input.txt";
 
 constexpr char dot{'.'};
 constexpr char gear{'*'};
 
-using Pos = array<unsigned int,2>;
-typedef map<Pos, char> SymbolMap;
-typedef map<Pos, vector<unsigned int>> NumberMap;
-
-static bool readFile(const string& fileName, vector<string>& lines) {
-   ifstream in(fileName);
-   if (!in) {
-       cerr << "Cannot open file " << fileName << endl;
-       return false;
-   }
+// a band this small is not worth a thread
+constexpr size_t cellsPerBand = 1 << 20;
 
-   auto closeStream =  [&in] {
-       in.close();
-   };
+struct Sums {
+    uint64_t parts{};  // numbers next to each symbol, over all symbols
+    uint64_t gears{};  // products of the two numbers next to each gear that has exactly two
+};
 
-   string str;
-   while (getline(in, str)) {
-       lines.push_back(str);
-   }
-
-   closeStream();
-   return true;
+static bool isDigit(char ch) {
+    return static_cast<unsigned>(ch - '0') < 10;
 }
 
-int main() {
-    vector<string> map;
-
-    if (!readFile(file1, map)) {
-        return EXIT_FAILURE;
+/*
+ * Labels every cell of a row with 1 + the number covering it, or 0. The labels are padded by
+ * one cell on both sides, so a neighbour lookup never leaves the row.
+ */
+static void label(string_view row, vector<uint32_t> &labels) {
+    fill(labels.begin(), labels.end(), 0);
+    for (size_t j = 0; j < row.size();) {
+        if (!isDigit(row[j])) {
+            ++j;
+            continue;
+        }
+        const auto first = j;
+        uint32_t value = 0;
+        for (; j < row.size() && isDigit(row[j]); ++j) {
+            value = value * 10 + static_cast<uint32_t>(row[j] - '0');
+        }
+        fill(labels.begin() + static_cast<ptrdiff_t>(first) + 1, labels.begin() + static_cast<ptrdiff_t>(j) + 1,
+             value + 1);
     }
+}
 
-    Pos dim{static_cast<unsigned int>(map.size()), static_cast<unsigned int>(map[0].size())};
-    map.insert(map.begin(), string(dim[1],dot));
-
-    for (auto& row : map) {
-        row = dot + row + dot;
+/*
+ * Sums the symbols of rows [first, last) through a window of three labelled rows, which also
+ * takes in one halo row above and below the band. Within three neighbouring cells of a row,
+ * the outer two belong to the same number exactly when the middle one is a digit, so a number
+ * is never counted twice for the same symbol.
+ */
+static Sums scanBand(const vector<string_view> &rows, size_t width, size_t first, size_t last) {
+    array<vector<uint32_t>, 3> window;
+    for (auto &labels: window) {
+        labels.assign(width + 2, 0);
     }
-
-    SymbolMap symbols;
-    for(unsigned int i = 1; i < dim[0] + 1; i++) {
-        for (unsigned int j = 1; j < dim[1] + 1; j++) {
-            if (!isdigit(map[i][j]) && dot != map[i][j]) {
-                symbols[Pos{i,j}] = map[i][j];
-            }
-        }
+    const auto slot = [&window](size_t row) -> vector<uint32_t> & {
+        return window[(row + 1) % 3];  // row -1 is the halo above the first row of the grid
+    };
+    if (first > 0) {
+        label(rows[first - 1], slot(first - 1));
     }
+    label(rows[first], slot(first));
+
+    Sums sums;
+    for (auto i = first; i < last; ++i) {
+        if (i + 1 < rows.size()) {
+            label(rows[i + 1], slot(i + 1));
+        } else {
+            fill(slot(i + 1).begin(), slot(i + 1).end(), 0);
+        }
 
-    NumberMap numbers;
-    for(unsigned int i = 1; i < dim[0] + 1; i++) {
-        vector<char> number;
-        vector<Pos> adjs;
-
-        for (unsigned int j=1; j < dim[1] + 2; j++) {
-            if (isdigit(map[i][j])) {
-                if (number.empty()) {
-                    adjs.push_back(Pos{i-1,j-1});
-                    adjs.push_back(Pos{i,j-1});
-                    adjs.push_back(Pos{i+1,j-1});
-                }
-                number.push_back(map[i][j]);
-                adjs.push_back(Pos{i-1, j});
-                adjs.push_back(Pos{i+1, j});
-            } else {
-                if (!number.empty()) {
-                    adjs.push_back(Pos{i-1,j});
-                    adjs.push_back(Pos{i,j});
-                    adjs.push_back(Pos{i+1,j});
-
-                    unsigned int n = stoull(string(number.begin(), number.end()));
-
-                    for (const auto& adj : adjs) {
-                        numbers[adj].push_back(n);
-                        }
+        const auto row = rows[i];
+        for (size_t j = 0; j < row.size(); ++j) {
+            if (dot == row[j] || isDigit(row[j])) {
+                continue;
+            }
+            uint32_t count = 0;
+            uint64_t sum = 0;
+            uint64_t product = 1;
+            const auto add = [&](uint32_t labelled) {
+                ++count;
+                sum += labelled - 1;
+                product *= labelled - 1;
+            };
+            for (const auto *labels: {&slot(i - 1), &slot(i), &slot(i + 1)}) {
+                const auto *cell = labels->data() + j + 1;
+                if (0 != cell[0]) {
+                    add(cell[0]);
+                } else {
+                    if (0 != cell[-1]) {
+                        add(cell[-1]);
+                    }
+                    if (0 != cell[1]) {
+                        add(cell[1]);
                     }
-                    number.clear();
-                    adjs.clear();
                 }
-
             }
-        }
-    cout << "Day 3\n";
-
-    // PART 1
-    unsigned int sumPart1 = 0;
-    for(const auto& symbol : symbols) {
-        const auto& pos = symbol.first;
-        const auto& it = numbers.find(pos);
-
-        if (it != numbers.end()) {
-            for (const auto& value : it->second) {
-                sumPart1 += value;
+            sums.parts += sum;
+            if (gear == row[j] && 2 == count) {
+                sums.gears += product;
             }
         }
     }
-    cout << "  Part 1\n"
-         << "    Sum of all part numbers : " << sumPart1 << "\n";
+    return sums;
+}
 
-    // PART 2
-    unsigned int sumPart2 = 0;
-    for(const auto& symbol : symbols) {
-        const auto& pos = symbol.first;
-        const auto& sym = symbol.second;
+/*
+ * Splits the schematic into horizontal bands that are scanned in parallel once it is
+ * large enough to be worth it
+ */
+static Sums scan(string_view input) {
+    const auto rows = aoc::splitLines(input);
+    if (rows.empty()) {
+        return {};
+    }
+    size_t width = 0;
+    for (const auto &row: rows) {
+        width = max(width, row.size());
+    }
 
-        if (gear == sym) {
-            const auto& it = numbers.find(pos);
-            if (it != numbers.end() && it->second.size() == 2) {
-                sumPart2 += it->second[0] * it->second[1];
+    const auto bands = min(rows.size(), max<size_t>(1, rows.size() * width / cellsPerBand));
+    if (1 == bands) {
+        return scanBand(rows, width, 0, rows.size());
+    }
+    vector<Sums> partial(bands);
+    aoc::ThreadPool::global().parallelFor(bands, [&](size_t band) {
+        partial[band] = scanBand(rows, width, rows.size() * band / bands, rows.size() * (band + 1) / bands);
+    });
+    Sums sums;
+    for (const auto &[parts, gears]: partial) {
+        sums.parts += parts;
+        sums.gears += gears;
+    }
+    return sums;
+}
 
-            }
-        }
+aoc::Answer solvePart1(string_view input) {
+    return to_string(scan(input).parts);
+}
+
+aoc::Answer solvePart2(string_view input) {
+    return to_string(scan(input).gears);
+}
+
+}  // namespace day3
+
+#ifndef AOC_LIBRARY
+int main() {
+    const aoc::MappedFile input(day3::file1);
+    if (!input) {
+        return EXIT_FAILURE;
     }
 
+    cout << "Day 3\n";
+
+    // PART 1
+    cout << "  Part 1\n"
+         << "    Sum of all part numbers : " << day3::solvePart1(input.view()) << "\n";
+
+    // PART 2
     cout << "  Part 2\n"
-         << "    Sum of all gear ratios : " << sumPart2 << "\n";
+         << "    Sum of all gear ratios : " << day3::solvePart2(input.view()) << "\n";
 }
+#endif
@@ -24,96 +24,150 @@
 // https://adventofcode.com/2023/day/4
 
 
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
 #include <iostream>
-#include <set>
-#include <vector>
+#include <span>
 #include <string>
-#include <sstream>
+#include "../Common/Input.h"
+#include "../Common/Parse.h"
+#include "../Common/Solver.h"
 
 
 using namespace std;
 
+namespace day4 {
+
 const string file1 = "input.txt";
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
+// scratchcard numbers stay below 100, so the numbers of a card fit one 128-bit mask
+constexpr unsigned int maskBits = 128;
+constexpr size_t maxWinning = 32;
+constexpr size_t maxNumbers = 64;
 
-    auto closeStream = [&in] {
-        in.close();
-    };
+// every number a card has may win, so it wins copies of at most maxNumbers cards ahead
+constexpr size_t ringSize = 128;
+static_assert(ringSize > maxNumbers && has_single_bit(ringSize));
 
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
-    }
+using Mask = array<uint64_t, maskBits / 64>;
 
-    closeStream();
+// Sets bit n for every number n; false when a number is past the mask
+static bool toMask(span<const unsigned int> numbers, Mask &mask) {
+    for (const auto n: numbers) {
+        if (n >= maskBits) {
+            return false;
+        }
+        mask[n / 64] |= uint64_t{1} << (n % 64);
+    }
     return true;
 }
 
-unsigned int processLine(vector<string> &lines, const bool test) {
-
-    unsigned int sum{};
-    vector<unsigned int> cards(lines.size(), 1);
-
-    for (const auto &line: lines) {
-        set<string> s;
-        istringstream iss{line};
-        unsigned int id;
-        string x;
+// How many of the card's numbers are winning numbers, a number had twice counting twice; false
+// for a card with more numbers than the buffers hold
+static bool matches(string_view line, unsigned int &c) {
+    const auto colon = line.find(':');
+    const auto bar = line.find('|');
+    array<unsigned int, maxWinning> winning{};
+    array<unsigned int, maxNumbers> numbers{};
+    const auto w = aoc::parseIntegers(line.substr(colon + 1, bar - colon - 1), span(winning));
+    const auto n = aoc::parseIntegers(line.substr(bar + 1), span(numbers));
+    if (w > winning.size() || n > numbers.size()) {
+        return false;
+    }
 
-        iss >> x;
-        iss >> id;
-        iss.ignore(1);
+    c = 0;
+    Mask winningMask{};
+    if (toMask(span(winning).first(w), winningMask)
+        && all_of(numbers.begin(), numbers.begin() + n, [](unsigned int number) { return number < maskBits; })) {
+        for (size_t i = 0; i < n; ++i) {
+            c += static_cast<unsigned int>(winningMask[numbers[i] / 64] >> (numbers[i] % 64) & 1);
+        }
+        return true;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (find(winning.begin(), winning.begin() + w, numbers[i]) != winning.begin() + w) {
+            c++;
+        }
+    }
+    return true;
+}
 
-        bool sep{false};
+static uint64_t totalPoints(string_view input) {
+    uint64_t sum{};
+    aoc::forEachLine(input, [&sum](string_view line) {
         unsigned int c{};
+        if (line.empty()) {
+            return;
+        }
+        if (!matches(line, c)) {
+            cerr << "Too many numbers on card : " << line << endl;
+            return;
+        }
+        if (c > 0) {
+            sum += uint64_t{1} << (c - 1);
+        }
+    });
+    return sum;
+}
 
-        while (iss >> x) {
-            if ('|' == x[0]) {
-                sep = true;
-                continue;
-            }
-            if (sep) {
-                if (s.find(x) != s.end()) {
-                    c++;
-                }
-            } else {
-                s.insert(x);
-            }
+/*
+ * Copies only ever flow to the next few cards, so the cards are streamed with a ring of the
+ * copies pending for the cards ahead instead of a count per card
+ */
+static uint64_t totalCards(string_view input) {
+    array<uint64_t, ringSize> pending{};
+    uint64_t sum{};
+    size_t card{};
+    aoc::forEachLine(input, [&](string_view line) {
+        unsigned int c{};
+        if (line.empty()) {
+            return;
         }
-        if (test) {
-            for (size_t i = 0; i < c; ++i) {
-                cards[id + i] += cards[id - 1];
-            }
-            sum += cards[id - 1];
-        } else {
-            sum += 1 << (c - 1);
+        if (!matches(line, c)) {
+            cerr << "Too many numbers on card : " << line << endl;
+            return;
         }
-    }
+        auto &slot = pending[card % ringSize];
+        const auto copies = 1 + slot;
+        slot = 0;
+        sum += copies;
+        for (size_t i = 1; i <= c; ++i) {
+            pending[(card + i) % ringSize] += copies;
+        }
+        ++card;
+    });
     return sum;
 }
 
+aoc::Answer solvePart1(string_view input) {
+    return to_string(totalPoints(input));
+}
+
+aoc::Answer solvePart2(string_view input) {
+    return to_string(totalCards(input));
+}
+
+}  // namespace day4
+
+#ifndef AOC_LIBRARY
 int main() {
 
     cout << "Day 4" << endl;
 
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
+    const aoc::MappedFile input(day4::file1);
+    if (!input) {
         return EXIT_FAILURE;
     }
 
     // Part 1
     cout << "  Part 1" << endl;
-    cout << "    Total points : " << processLine(lines, false) << endl;
+    cout << "    Total points : " << day4::solvePart1(input.view()) << endl;
 
     // Part 2
     cout << "  Part 2" << endl;
-    cout << "    Total scratchcards : " << processLine(lines, true) << endl;
+    cout << "    Total scratchcards : " << day4::solvePart2(input.view()) << endl;
 
 }
+#endif
@@ -25,137 +25,368 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <chrono>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <random>
+#include <span>
 #include <string>
 #include <vector>
 #include <cstdint>
+#include "../Common/Input.h"
+#include "../Common/Parse.h"
+#include "../Common/Solver.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DAY5_AVX2 1
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
+namespace day5 {
+
 const string file1 = "input.txt";
 
-using Range = array<uint64_t,3>;
+using Range = array<uint64_t,3>;  // destination, source, length
 using Map = vector<Range>;
 using Maps = vector<Map>;
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
+/*
+ * A map as a total piecewise-linear function: a piece adds its offset (modulo 2^64) to every
+ * value from its start up to the start of the next piece. The first piece starts at 0 and values
+ * outside every range get offset 0, so two functions compose piece by piece.
+ */
+struct Piece {
+    uint64_t start;
+    uint64_t offset;
+};
+using Function = vector<Piece>;
 
-    auto closeStream = [&in] {
-        in.close();
-    };
+// Last value covered by piece i
+static uint64_t last(const Function &f, size_t i) {
+    return i + 1 < f.size() ? f[i + 1].start - 1 : UINT64_MAX;
+}
 
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
+// Index of the piece covering v
+static size_t find(const Function &f, uint64_t v) {
+    const auto it = upper_bound(f.begin(), f.end(), v, [](uint64_t value, const Piece &piece) {
+        return value < piece.start;
+    });
+    return static_cast<size_t>(it - f.begin()) - 1;
+}
+
+// Appends a piece, or extends the last one when both shift by the same offset
+static void append(Function &f, const Piece &piece) {
+    if (f.empty() || f.back().offset != piece.offset) {
+        f.push_back(piece);
     }
+}
 
-    closeStream();
-    return true;
+static Function toFunction(Map map) {
+    sort(map.begin(), map.end(), [](const Range &a, const Range &b) { return a[1] < b[1]; });
+    Function f;
+    uint64_t next = 0;
+    for (const auto &[destination, source, length]: map) {
+        if (0 == length) {
+            continue;
+        }
+        if (source > next) {
+            append(f, {next, 0});
+        }
+        append(f, {source, destination - source});
+        next = source + length;
+    }
+    append(f, {next, 0});
+    return f;
 }
 
-int main() {
+// g after f: each piece of f maps onto one contiguous run of values, split where g's pieces split it
+static Function compose(const Function &f, const Function &g) {
+    Function h;
+    for (size_t i = 0; i < f.size(); ++i) {
+        const auto offset = f[i].offset;
+        auto value = f[i].start + offset;
+        const auto lastValue = last(f, i) + offset;
+        for (auto j = find(g, value);; ++j) {
+            append(h, {value - offset, offset + g[j].offset});
+            if (last(g, j) >= lastValue) {
+                break;
+            }
+            value = last(g, j) + 1;
+        }
+    }
+    return h;
+}
 
-    cout << "Day 5" << endl;
+/*
+ * Every map of the almanac composed into one function from seed to location, so a seed or a
+ * whole range of seeds costs a binary search however many maps and ranges there are
+ */
+class Almanac {
+public:
+    explicit Almanac(const Maps &maps) {
+        for (const auto &map: maps) {
+            location = compose(location, toFunction(map));
+        }
+    }
 
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
-        return EXIT_FAILURE;
+    [[nodiscard]] uint64_t locate(uint64_t seed) const {
+        return seed + location[find(location, seed)].offset;
     }
 
-    Maps maps;
-    {
-        lines.push_back("");
-        Map map;
-        for (size_t i = 3; i < lines.size(); ++i) {
-            if (lines[i].empty()) {
-                maps.push_back(map);
-                map.clear();
-                i++;
-                continue;
-            }
-            std::istringstream iss{lines[i]};
-            uint64_t d, s, l;
-            iss >> d >> s >> l;
-            map.push_back({d, s, l});
+    // Lowest location of the seeds in [first, first + count): where each piece they cross begins
+    [[nodiscard]] uint64_t lowest(uint64_t first, uint64_t count) const {
+        if (0 == count) {
+            return UINT64_MAX;
+        }
+        const auto lastSeed = first + count - 1;
+        uint64_t result{UINT64_MAX};
+        for (auto i = find(location, first); i < location.size() && location[i].start <= lastSeed; ++i) {
+            result = min(result, max(first, location[i].start) + location[i].offset);
+        }
+        return result;
+    }
+
+    [[nodiscard]] const Function &function() const {
+        return location;
+    }
+
+private:
+    Function location{{0, 0}};
+};
+
+/*
+ * The seed-to-location function of an Almanac laid out for batches of single seeds: piece
+ * starts and offsets in separate arrays, padded to a power of two by repeating the last piece,
+ * so every lookup is the same number of branchless halving steps. With AVX2, four seeds are
+ * searched at once with gathers, and two such groups are interleaved to hide their latency.
+ */
+class SeedIndex {
+public:
+    explicit SeedIndex(const Almanac &almanac) {
+        const auto &f = almanac.function();
+        starts.assign(bit_ceil(f.size()), f.back().start);
+        offsets.assign(starts.size(), f.back().offset);
+        for (size_t i = 0; i < f.size(); ++i) {
+            starts[i] = f[i].start;
+            offsets[i] = f[i].offset;
         }
     }
 
-    {
-        // Part 1
-        std::vector<uint64_t> seeds;
-        std::istringstream iss{lines[0]};
-        iss.ignore(6);
-        uint64_t x;
-        while (iss >> x) {
-            seeds.push_back(x);
+    // Writes the location of seeds[i] to locations[i]
+    void locate(span<const uint64_t> seeds, span<uint64_t> locations) const {
+#ifdef DAY5_AVX2
+        if (hasAvx2()) {
+            locateAvx2(seeds, locations);
+            return;
         }
+#endif
+        locateScalar(seeds, locations);
+    }
 
-        auto values = seeds;
-        for (const auto& map : maps) {
-            for (auto& v : values) {
-                for (const auto& range : map) {
-                    if (v >= range[1] && v < range[1] + range[2]) {
-                        v += range[0] - range[1];
-                        break;
-                    }
-                }
+    void locateScalar(span<const uint64_t> seeds, span<uint64_t> locations, size_t from = 0) const {
+        for (auto i = from; i < seeds.size(); ++i) {
+            size_t piece = 0;
+            for (auto step = starts.size() / 2; step > 0; step /= 2) {
+                piece += static_cast<size_t>(starts[piece + step] <= seeds[i]) * step;
             }
+            locations[i] = seeds[i] + offsets[piece];
         }
-        const auto minLocation = *std::min_element(values.begin(), values.end());
+    }
 
-        cout << "  Part 1" << endl;
-        cout << "     Lowest location : " << minLocation << endl;
+#ifdef DAY5_AVX2
+    static bool hasAvx2() {
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+    }
 
+    __attribute__((target("avx2"))) void locateAvx2(span<const uint64_t> seeds, span<uint64_t> locations) const {
+        const auto *startData = reinterpret_cast<const long long *>(starts.data());
+        const auto *offsetData = reinterpret_cast<const long long *>(offsets.data());
+        // AVX2 only compares signed: flipping the sign bit of both sides orders them as unsigned
+        const auto sign = _mm256_set1_epi64x(INT64_MIN);
+        size_t i = 0;
+        for (; i + 8 <= seeds.size(); i += 8) {
+            const auto seedsA = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(seeds.data() + i));
+            const auto seedsB = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(seeds.data() + i + 4));
+            const auto keyA = _mm256_xor_si256(seedsA, sign);
+            const auto keyB = _mm256_xor_si256(seedsB, sign);
+            auto pieceA = _mm256_setzero_si256();
+            auto pieceB = _mm256_setzero_si256();
+            for (auto step = starts.size() / 2; step > 0; step /= 2) {
+                const auto stride = _mm256_set1_epi64x(static_cast<long long>(step));
+                const auto startA = _mm256_i64gather_epi64(startData, _mm256_add_epi64(pieceA, stride), 8);
+                const auto startB = _mm256_i64gather_epi64(startData, _mm256_add_epi64(pieceB, stride), 8);
+                const auto pastA = _mm256_cmpgt_epi64(_mm256_xor_si256(startA, sign), keyA);
+                const auto pastB = _mm256_cmpgt_epi64(_mm256_xor_si256(startB, sign), keyB);
+                pieceA = _mm256_add_epi64(pieceA, _mm256_andnot_si256(pastA, stride));
+                pieceB = _mm256_add_epi64(pieceB, _mm256_andnot_si256(pastB, stride));
+            }
+            const auto offsetA = _mm256_i64gather_epi64(offsetData, pieceA, 8);
+            const auto offsetB = _mm256_i64gather_epi64(offsetData, pieceB, 8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(locations.data() + i), _mm256_add_epi64(seedsA, offsetA));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(locations.data() + i + 4),
+                                _mm256_add_epi64(seedsB, offsetB));
+        }
+        locateScalar(seeds, locations, i);
     }
+#endif
 
-    {  // Part 2
-        std::vector<std::array<uint64_t, 2>> seeds;
-        std::istringstream iss{lines[0]};
-        iss.ignore(6);
-        uint64_t x, y;
-        while (iss >> x >> y) {
-            seeds.push_back({x, y});
+    // Seeds from here on all share the last offset
+    [[nodiscard]] uint64_t lastStart() const {
+        return starts.back();
+    }
+
+private:
+    vector<uint64_t> starts;
+    vector<uint64_t> offsets;
+};
+
+static Maps toMaps(const vector<string_view> &lines) {
+    Maps maps;
+    Map map;
+    for (size_t i = 3; i <= lines.size(); ++i) {
+        if (i == lines.size() || lines[i].empty()) {
+            maps.push_back(map);
+            map.clear();
+            i++;
+            continue;
+        }
+        Range range{};
+        if (aoc::parseIntegers(lines[i], span(range)) != range.size()) {
+            cerr << "Not a range : " << lines[i] << endl;
+            continue;
         }
+        map.push_back(range);
+    }
+    return maps;
+}
 
-        uint64_t minLocation{UINT64_MAX};
-        for (const auto& seed : seeds) {
-            for (uint64_t j = 0; j < seed[1]; ++j) {
-                uint64_t v = seed[0] + j;
-                std::vector<uint64_t> toSkip;
-                for (auto & map : maps) {
-                    uint64_t minSkip{UINT64_MAX};
-                    for (const auto& range : map) {
-                        if (v >= range[1]) {
-                            if (v < range[1] + range[2]) {
-                                toSkip.push_back(range[1] + range[2] - v - 1);
-                                v += range[0] - range[1];
-                                break;
-                            }
-                        } else {
-                            minSkip = std::min(minSkip, range[1] - v - 1);
-                        }
-                    }
-                    if (minSkip < UINT64_MAX) {
-                        toSkip.push_back(minSkip);
-                    }
-                }
-                if (!toSkip.empty()) {
-                    j += *std::min_element(toSkip.begin(), toSkip.end());
+// the seeds line usually has no more numbers than spaces; if it has, it is parsed again
+static vector<uint64_t> toSeeds(string_view line) {
+    vector<uint64_t> seeds(count(line.begin(), line.end(), ' '));
+    const auto n = aoc::parseIntegers(line, span(seeds));
+    const auto fits = n <= seeds.size();
+    seeds.resize(n);
+    if (!fits) {
+        aoc::parseIntegers(line, span(seeds));
+    }
+    return seeds;
+}
+
+aoc::Answer solvePart1(string_view input) {
+    const auto lines = aoc::splitLines(input);
+    const SeedIndex index(Almanac(toMaps(lines)));
+
+    const auto seeds = toSeeds(lines[0]);
+    vector<uint64_t> locations(seeds.size());
+    index.locate(seeds, locations);
+    return to_string(*min_element(locations.begin(), locations.end()));
+}
+
+aoc::Answer solvePart2(string_view input) {
+    const auto lines = aoc::splitLines(input);
+    const Almanac almanac(toMaps(lines));
+
+    const auto numbers = toSeeds(lines[0]);
+    uint64_t minLocation{UINT64_MAX};
+    for (size_t i = 0; i + 1 < numbers.size(); i += 2) {
+        minLocation = min(minLocation, almanac.lowest(numbers[i], numbers[i + 1]));
+    }
+    return to_string(minLocation);
+}
+
+}  // namespace day5
+
+#ifndef AOC_LIBRARY
+/*
+ * Looks up `queries` random seeds, 64K at a time, with every SeedIndex path, checks that they
+ * agree with Almanac::locate and reports queries/s
+ */
+static bool benchmarkQueries(string_view input, uint64_t queries) {
+    const auto lines = aoc::splitLines(input);
+    const day5::Almanac almanac(day5::toMaps(lines));
+    const day5::SeedIndex index(almanac);
+
+    constexpr size_t batch = 1 << 16;
+    vector<uint64_t> seeds(batch);
+    vector<uint64_t> locations(batch);
+    mt19937_64 rng(queries);
+    uniform_int_distribution<uint64_t> seed(0, 2 * index.lastStart());
+
+    const auto measure = [&](const char *name, auto locate) {
+        double seconds{};
+        uint64_t checksum{};
+        for (uint64_t done = 0; done < queries; done += batch) {
+            const auto n = static_cast<size_t>(min<uint64_t>(batch, queries - done));
+            generate_n(seeds.begin(), n, [&] { return seed(rng); });
+            const auto start = chrono::steady_clock::now();
+            locate(span(seeds).first(n), span(locations).first(n));
+            const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+            seconds += elapsed.count();
+            for (size_t i = 0; i < n; ++i) {
+                if (locations[i] != almanac.locate(seeds[i])) {
+                    cerr << name << ": seed " << seeds[i] << " located at " << locations[i] << " instead of "
+                         << almanac.locate(seeds[i]) << endl;
+                    return false;
                 }
-                minLocation = std::min(minLocation, v);
+                checksum += locations[i];
             }
         }
+        cout << "    " << name << ": " << static_cast<uint64_t>(static_cast<double>(queries) / seconds)
+             << " queries/s (checksum " << checksum << ")" << endl;
+        return true;
+    };
+
+    cout << "  " << queries << " seed queries over " << almanac.function().size() << " pieces" << endl;
+    bool ok = measure("binary search", [&almanac](auto s, auto l) {
+        transform(s.begin(), s.end(), l.begin(), [&almanac](uint64_t seed) { return almanac.locate(seed); });
+    });
+    rng.seed(queries);
+    ok = ok && measure("branchless", [&index](auto s, auto l) { index.locateScalar(s, l); });
+#ifdef DAY5_AVX2
+    if (day5::SeedIndex::hasAvx2()) {
+        rng.seed(queries);
+        ok = ok && measure("AVX2", [&index](auto s, auto l) { index.locateAvx2(s, l); });
+    }
+#endif
+    return ok;
+}
 
-        cout << "  Part 2" << endl;
-        cout << "     Lowest location of initial seeds: " << minLocation << endl;
+/*
+ * Usage: Day_5 [--queries <n>]
+ * With --queries, also answers n random single-seed lookups in batches and reports the rate.
+ */
+int main(int argc, char *argv[]) {
+    uint64_t queries{};
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        if ("--queries" == arg && i + 1 < argc) {
+            queries = stoull(argv[++i]);
+        } else {
+            cerr << "Usage: " << argv[0] << " [--queries <n>]" << endl;
+            return EXIT_FAILURE;
+        }
     }
 
+    cout << "Day 5" << endl;
+
+    const aoc::MappedFile input(day5::file1);
+    if (!input) {
+        return EXIT_FAILURE;
+    }
+
+    cout << "  Part 1" << endl;
+    cout << "     Lowest location : " << day5::solvePart1(input.view()) << endl;
+
+    cout << "  Part 2" << endl;
+    cout << "     Lowest location of initial seeds: " << day5::solvePart2(input.view()) << endl;
+
+    if (0 != queries && !benchmarkQueries(input.view(), queries)) {
+        return EXIT_FAILURE;
+    }
     return EXIT_SUCCESS;
 }
+#endif
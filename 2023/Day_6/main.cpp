@@ -21,64 +21,141 @@
  */
 
 // Advent of Code Day 6
-// https://adventofcode.com/2023/day/5
+// https://adventofcode.com/2023/day/6
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <fstream>
 #include <iostream>
-#include <sstream>
+#include <array>
+#include <random>
+#include <span>
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <complex>
+#include "../Common/Input.h"
+#include "../Common/Parse.h"
+#include "../Common/Solver.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DAY6_AVX2 1
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
+namespace day6 {
+
 const string file1 = "input.txt";
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
+__extension__ using u128 = unsigned __int128;
 
-    auto closeStream = [&in] {
-        in.close();
-    };
+// floor(sqrt(n)), exact over the whole 128-bit range
+static uint64_t isqrt(u128 n) {
+    const auto estimate = sqrt(static_cast<double>(n));
+    uint64_t r = estimate >= 0x1p64 ? UINT64_MAX : static_cast<uint64_t>(estimate);
+    // a double is good to 53 bits: past 2^104 one Newton step brings the estimate within one
+    if (0 != n >> 104) {
+        r = static_cast<uint64_t>(min<u128>((r + n / r) / 2, UINT64_MAX));
+    }
+    while (static_cast<u128>(r) * r > n) {
+        --r;
+    }
+    while (r < UINT64_MAX && static_cast<u128>(r + 1) * (r + 1) <= n) {
+        ++r;
+    }
+    return r;
+}
 
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
+/*
+ * Ways to beat distance d in a race of t ms. Holding the button x ms wins when x (t - x) > d,
+ * that is when (t - 2x)^2 < t^2 - 4d: t - 2x takes the values of t's parity in [-r, r],
+ * r = isqrt(t^2 - 4d - 1). Exact for every t and d.
+ */
+static uint64_t wins(uint64_t t, uint64_t d) {
+    const auto square = static_cast<u128>(t) * t;
+    const auto record = static_cast<u128>(d) * 4;
+    if (square <= record) {
+        return 0;
     }
+    const auto r = isqrt(square - record - 1);
+    return r + (0 == ((r ^ t) & 1) ? 1 : 0);
+}
 
-    closeStream();
-    return true;
+#ifdef DAY6_AVX2
+static bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
 }
 
-auto winsAnalysis =[](const uint64_t t, const uint64_t d) {
-    const auto s = sqrt(t * t / 4. - d);
-    auto x1 = static_cast<uint64_t>(ceil(t / 2. - s));
-    auto x2 = static_cast<uint64_t>(floor(t / 2. + s));
-    x1 += (x1 * (t - x1) <= d) ? 1 : 0;
-    x2 -= (x2 * (t - x2) <= d) ? 1 : 0;
-    return x2 - x1 + 1;
-};
+/*
+ * Four races at a time while every time is below 2^26: t^2 - 4d then fits the 52-bit mantissa
+ * of a double, so the square root is a vector sqrt fixed up by one step each way
+ */
+__attribute__((target("avx2"))) static size_t winsAvx2(span<const uint64_t> times, span<const uint64_t> distances,
+                                                         span<uint64_t> out) {
+    const auto one = _mm256_set1_epi64x(1);
+    const auto magic = _mm256_set1_epi64x(0x4330000000000000);  // 2^52: its mantissa holds the integer
+    const auto magicDouble = _mm256_castsi256_pd(magic);
+    size_t i = 0;
+    for (; i + 4 <= times.size(); i += 4) {
+        const auto t = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(times.data() + i));
+        const auto d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(distances.data() + i));
+        const auto wide = _mm256_srli_epi64(t, 26);
+        if (!_mm256_testz_si256(wide, wide)) {
+            for (size_t j = i; j < i + 4; ++j) {
+                out[j] = wins(times[j], distances[j]);
+            }
+            continue;
+        }
+        const auto square = _mm256_mul_epu32(t, t);
+        const auto record = _mm256_slli_epi64(d, 2);
+        const auto small = _mm256_cmpeq_epi64(_mm256_srli_epi64(d, 50), _mm256_setzero_si256());
+        const auto valid = _mm256_and_si256(small, _mm256_cmpgt_epi64(square, record));
+        const auto n = _mm256_and_si256(valid, _mm256_sub_epi64(_mm256_sub_epi64(square, record), one));
 
-auto toNumbers = [](string& line) {
-    vector<uint64_t> numbers;
-    istringstream iss(line);
-    iss.ignore(9);
+        const auto root = _mm256_floor_pd(_mm256_sqrt_pd(
+                _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(n, magic)), magicDouble)));
+        auto r = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(root, magicDouble)), magic);
+        r = _mm256_add_epi64(r, _mm256_cmpgt_epi64(_mm256_mul_epu32(r, r), n));
+        const auto next = _mm256_add_epi64(r, one);
+        r = _mm256_sub_epi64(r, _mm256_andnot_si256(_mm256_cmpgt_epi64(_mm256_mul_epu32(next, next), n),
+                                                    _mm256_set1_epi64x(-1)));
 
-    uint64_t  x;
-    while(iss >> x) {
-        numbers.push_back(x);
+        const auto odd = _mm256_and_si256(_mm256_xor_si256(r, t), one);
+        const auto count = _mm256_add_epi64(r, _mm256_xor_si256(odd, one));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out.data() + i), _mm256_and_si256(count, valid));
     }
+    return i;
+}
+#endif
+
+// out[i] = wins(times[i], distances[i]), vectorized where the CPU allows
+static void wins(span<const uint64_t> times, span<const uint64_t> distances, span<uint64_t> out) {
+    size_t i = 0;
+#ifdef DAY6_AVX2
+    if (hasAvx2()) {
+        i = winsAvx2(times, distances, out);
+    }
+#endif
+    for (; i < times.size(); ++i) {
+        out[i] = wins(times[i], distances[i]);
+    }
+}
 
-    return numbers;
+auto toNumbers = [](string_view line) {
+    array<uint64_t, 16> numbers{};
+    const auto n = aoc::parseIntegers(line, span(numbers));
+    if (n > numbers.size()) {
+        vector<uint64_t> all(n);
+        aoc::parseIntegers(line, span(all));
+        return all;
+    }
+    return vector<uint64_t>(numbers.begin(), numbers.begin() + static_cast<ptrdiff_t>(n));
 };
 
-auto toNumberFromDigits = [](string& line) {
+auto toNumberFromDigits = [](string_view line) {
     uint64_t number{};
 
     for (const auto c : line) {
@@ -90,10 +167,134 @@ auto toNumberFromDigits = [](string& line) {
     return number;
 };
 
-int main() {
+aoc::Answer solvePart1(string_view input) {
+    const auto lines = aoc::splitLines(input);
+    const auto times = toNumbers(lines[0]);
+    const auto distances = toNumbers(lines[1]);
+
+    vector<uint64_t> counts(times.size());
+    wins(times, distances, counts);
+    uint64_t p1{1};
+    for (const auto count: counts) {
+        p1 *= count;
+    }
+    return to_string(p1);
+}
+
+aoc::Answer solvePart2(string_view input) {
+    const auto lines = aoc::splitLines(input);
+    const auto p2 = wins(toNumberFromDigits(lines[0]), toNumberFromDigits(lines[1]));
+    return to_string(p2);
+}
 
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
+}  // namespace day6
+
+#ifndef AOC_LIBRARY
+/*
+ * Checks `races` random races of both solvers: small ones against counting every hold, large
+ * ones against the definition at the edges of the winning holds
+ */
+static bool check(uint64_t races) {
+    using day6::u128;
+    mt19937_64 rng(races);
+    vector<uint64_t> times(races);
+    vector<uint64_t> distances(races);
+    vector<uint64_t> counts(races);
+    for (const bool large: {false, true}) {
+        for (uint64_t i = 0; i < races; ++i) {
+            times[i] = large ? rng() >> (rng() % 64) : rng() % 1000;
+            const auto best = static_cast<u128>(times[i] / 2) * (times[i] - times[i] / 2);
+            distances[i] = static_cast<uint64_t>(min<u128>(best * (rng() % 1001) / 1000, UINT64_MAX));
+        }
+        day6::wins(times, distances, counts);
+        for (uint64_t i = 0; i < races; ++i) {
+            const auto t = times[i];
+            const auto d = distances[i];
+            const auto beats = [t, d](uint64_t x) { return static_cast<u128>(x) * (t - x) > d; };
+            bool agree;
+            if (large) {
+                // the winning holds are the w holds around t / 2: the ones at the edges win, past them not
+                const auto w = counts[i];
+                const auto first = (t - w + 1) / 2;
+                const auto last = first + w - 1;
+                agree = 0 == w ? !beats(t / 2)
+                               : beats(first) && (0 == first || !beats(first - 1)) && beats(last) &&
+                                 (t == last || !beats(last + 1));
+            } else {
+                uint64_t expected{};
+                for (uint64_t x = 0; x <= t; ++x) {
+                    expected += beats(x) ? 1 : 0;
+                }
+                agree = counts[i] == expected;
+            }
+            if (!agree || day6::wins(t, d) != counts[i]) {
+                cerr << "    race t=" << t << " d=" << d << ": " << counts[i] << " ways in a batch, "
+                     << day6::wins(t, d) << " alone" << endl;
+                return false;
+            }
+        }
+    }
+    cout << "    " << races << " small and " << races << " large races agree" << endl;
+    return true;
+}
+
+// Solves `races` random Part 1 sized races, 64K at a time, and reports races/s
+static void benchmark(uint64_t races) {
+    constexpr size_t batch = 1 << 16;
+    mt19937_64 rng(races);
+    vector<uint64_t> times(batch);
+    vector<uint64_t> distances(batch);
+    vector<uint64_t> counts(batch);
+    const auto measure = [&](const char *name, auto solve) {
+        rng.seed(races);
+        double seconds{};
+        uint64_t checksum{};
+        for (uint64_t done = 0; done < races; done += batch) {
+            const auto n = static_cast<size_t>(min<uint64_t>(batch, races - done));
+            for (size_t i = 0; i < n; ++i) {
+                times[i] = 7 + rng() % 100000;
+                distances[i] = rng() % (times[i] * times[i] / 4);
+            }
+            const auto start = chrono::steady_clock::now();
+            solve(span(times).first(n), span(distances).first(n), span(counts).first(n));
+            const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+            seconds += elapsed.count();
+            for (size_t i = 0; i < n; ++i) {
+                checksum += counts[i];
+            }
+        }
+        cout << "    " << name << ": " << static_cast<uint64_t>(static_cast<double>(races) / seconds)
+             << " races/s (checksum " << checksum << ")" << endl;
+    };
+    measure("one at a time", [](auto t, auto d, auto out) {
+        for (size_t i = 0; i < t.size(); ++i) {
+            out[i] = day6::wins(t[i], d[i]);
+        }
+    });
+    measure("batch", [](auto t, auto d, auto out) { day6::wins(t, d, out); });
+}
+
+/*
+ * Usage: Day_6 [--check <n>] [--races <n>]
+ * --check cross-checks the solvers on n random races, --races times n random races in batches.
+ */
+int main(int argc, char *argv[]) {
+    uint64_t checks{};
+    uint64_t races{};
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        if ("--check" == arg && i + 1 < argc) {
+            checks = stoull(argv[++i]);
+        } else if ("--races" == arg && i + 1 < argc) {
+            races = stoull(argv[++i]);
+        } else {
+            cerr << "Usage: " << argv[0] << " [--check <n>] [--races <n>]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    const aoc::MappedFile input(day6::file1);
+    if (!input) {
         return EXIT_FAILURE;
     }
 
@@ -101,25 +302,27 @@ int main() {
 
     {
         // PART 1
-        const auto times = toNumbers(lines[0]);
-        const auto distances = toNumbers(lines[1]);
-
-        uint64_t p1{1};
-        for (size_t i = 0; i < times.size(); i++) {
-            p1 *=  winsAnalysis(times[i], distances[i]);
-        }
-
         cout << "  Part 1" << endl;
-        cout << "    Ways to beat the record : " << p1 << endl;
+        cout << "    Ways to beat the record : " << day6::solvePart1(input.view()) << endl;
 
     }
 
     {  // Part 2
-        uint64_t p2;
-        p2 = winsAnalysis(toNumberFromDigits(lines[0]), toNumberFromDigits(lines[1]));
         cout << "  Part 2" << endl;
-        cout << "    Ways to beat the record in one race : " << p2 << endl;
+        cout << "    Ways to beat the record in one race : " << day6::solvePart2(input.view()) << endl;
+    }
+
+    if (0 != checks) {
+        cout << "  Cross-check" << endl;
+        if (!check(checks)) {
+            return EXIT_FAILURE;
+        }
+    }
+    if (0 != races) {
+        cout << "  Throughput" << endl;
+        benchmark(races);
     }
 
     return EXIT_SUCCESS;
 }
+#endif
@@ -4,120 +4,359 @@
 
 #include <algorithm>
 #include <array>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 #include <cstdint>
-#include <cassert>
-#include <sstream>
-#include <unordered_map>
+#include "../Common/Input.h"
+#include "../Common/Parse.h"
+#include "../Common/Solver.h"
+
+namespace day7 {
 
-const std::string lookup = "lookup.txt";
 const std::string file1 = "input.txt";
 
-// Prime values for card ranks
-const int primes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41 };
-const std::vector<char> cardValues = {'2','3','4','5','6','7','8','9','T','J','Q','K','A'};
+constexpr std::string_view cards = "23456789TJQKA";       // weakest to strongest
+constexpr std::string_view spellingOrder = "23456789AJKQT";  // by character code, the order ties are broken in
+constexpr uint32_t multisets = 6188;                         // C(17, 5): 5 of 13 ranks, repeats allowed
+constexpr uint32_t spellings = 13 * 13 * 13 * 13 * 13;
 
-// Hashing function using prime numbers for card ranks
-uint64_t hashHand(const std::string& hand) {
-    uint64_t hashValue = 1; // Initialize with 1 to avoid hashValue being 0
-    for (const auto& card : hand) {
+// Position of each card character in an order, or -1
+constexpr std::array<int8_t, 256> indexIn(std::string_view order) {
+    std::array<int8_t, 256> index{};
+    index.fill(-1);
+    for (size_t i = 0; i < order.size(); ++i) {
+        index[static_cast<unsigned char>(order[i])] = static_cast<int8_t>(i);
+    }
+    return index;
+}
 
-        // get card index
-        auto index = find(cardValues.begin(), cardValues.end(),card) - cardValues.begin();
-        hashValue *= primes[index];
+constexpr auto strength = indexIn(cards);
+constexpr auto spelling = indexIn(spellingOrder);
 
+constexpr auto binomial = [] {
+    std::array<std::array<uint32_t, 6>, 18> c{};
+    for (size_t n = 0; n < c.size(); ++n) {
+        c[n][0] = 1;
+        for (size_t k = 1; k < c[n].size() && k <= n; ++k) {
+            c[n][k] = c[n - 1][k - 1] + (k < n ? c[n - 1][k] : 0);
         }
-    return hashValue;
     }
+    return c;
+}();
 
+using Cards = std::array<int, 5>;  // card strengths, sorted ascending
 
-static bool readFile(const std::string &fileName, std::vector<std::string> &lines) {
-    std::ifstream in(fileName);
-    if (!in) {
-        std::cerr << "Cannot open file " << fileName << std::endl;
-        return false;
+// Shifting a <= b <= c <= d <= e to a < b+1 < c+2 < d+3 < e+4 makes every multiset of five
+// cards a combination of 5 out of 17, numbered from 0 in the combinatorial number system
+constexpr uint32_t multisetIndex(const Cards &sorted) {
+    uint32_t index = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        index += binomial[static_cast<size_t>(sorted[i]) + i][i + 1];
     }
+    return index;
+}
+
+// Optimal 9-comparator network for five, written out so that the cards stay in registers; each
+// exchange moves the difference under a sign mask, since GCC turns min/max here into branches
+constexpr void sortCards(Cards &cards) {
+    const auto exchange = [&cards](size_t i, size_t j) {
+        const auto diff = cards[j] - cards[i];
+        const auto swap = diff & (diff >> 31);  // diff when cards[j] < cards[i], else 0
+        cards[i] += swap;
+        cards[j] -= swap;
+    };
+    exchange(0, 1);
+    exchange(3, 4);
+    exchange(2, 4);
+    exchange(2, 3);
+    exchange(1, 4);
+    exchange(0, 3);
+    exchange(0, 2);
+    exchange(1, 3);
+    exchange(1, 2);
+}
 
-    auto closeStream = [&in] {
-        in.close();
+/*
+ * Poker rank of every multiset of five cards, weakest 0, by multisetIndex. Poker order without
+ * suits: the multisets are enumerated category by category from high card up to five of a
+ * kind, each category in ascending order of its largest group, then the next, and so on. A
+ * straight counts by its top card, the wheel A2345 being the lowest.
+ */
+constexpr auto multisetRank = [] {
+    std::array<uint16_t, multisets> rank{};
+    uint16_t next = 0;
+    const auto add = [&rank, &next](Cards hand) {
+        sortCards(hand);
+        rank[multisetIndex(hand)] = next++;
     };
+    constexpr int ace = 12;
 
-    std::string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
+    // high card: five different cards that do not make a straight
+    for (int a = 4; a <= ace; ++a) {
+        for (int b = 3; b < a; ++b) {
+            for (int c = 2; c < b; ++c) {
+                for (int d = 1; d < c; ++d) {
+                    for (int e = 0; e < d; ++e) {
+                        if (4 != a - e && !(ace == a && 3 == b)) {
+                            add({a, b, c, d, e});
+                        }
+                    }
+                }
+            }
+        }
+    }
+    // one pair
+    for (int p = 0; p <= ace; ++p) {
+        for (int a = 2; a <= ace; ++a) {
+            for (int b = 1; b < a; ++b) {
+                for (int c = 0; c < b; ++c) {
+                    if (p != a && p != b && p != c) {
+                        add({p, p, a, b, c});
+                    }
+                }
+            }
+        }
+    }
+    // two pair
+    for (int h = 1; h <= ace; ++h) {
+        for (int l = 0; l < h; ++l) {
+            for (int k = 0; k <= ace; ++k) {
+                if (h != k && l != k) {
+                    add({h, h, l, l, k});
+                }
+            }
+        }
+    }
+    // three of a kind
+    for (int t = 0; t <= ace; ++t) {
+        for (int a = 1; a <= ace; ++a) {
+            for (int b = 0; b < a; ++b) {
+                if (t != a && t != b) {
+                    add({t, t, t, a, b});
+                }
+            }
+        }
     }
+    // straights
+    add({0, 1, 2, 3, ace});
+    for (int top = 4; top <= ace; ++top) {
+        add({top - 4, top - 3, top - 2, top - 1, top});
+    }
+    // full house
+    for (int t = 0; t <= ace; ++t) {
+        for (int p = 0; p <= ace; ++p) {
+            if (t != p) {
+                add({t, t, t, p, p});
+            }
+        }
+    }
+    // four of a kind
+    for (int q = 0; q <= ace; ++q) {
+        for (int k = 0; k <= ace; ++k) {
+            if (q != k) {
+                add({q, q, q, q, k});
+            }
+        }
+    }
+    // five of a kind
+    for (int f = 0; f <= ace; ++f) {
+        add({f, f, f, f, f});
+    }
+    return rank;
+}();
+static_assert(0 == multisetRank[multisetIndex({0, 1, 2, 3, 5})] &&
+              multisets - 1 == multisetRank[multisetIndex({12, 12, 12, 12, 12})]);
 
-    closeStream();
+/*
+ * Sort key of a hand packed in 32 bits: the poker rank of its cards, then its characters as a
+ * base-13 number in character code order, which is how hands of equal rank have always been
+ * ordered. False for anything but five card characters.
+ */
+inline bool handKey(std::string_view hand, uint32_t &key) {
+    if (hand.size() < 5) {
+        return false;
+    }
+    Cards sorted{};
+    uint32_t spelled = 0;
+    int invalid = 0;  // negative once any character is not a card
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        const auto ch = static_cast<unsigned char>(hand[i]);
+        sorted[i] = strength[ch];
+        invalid |= strength[ch];
+        spelled = spelled * 13 + static_cast<uint32_t>(spelling[ch]);
+    }
+    if (invalid < 0) {
+        return false;
+    }
+    sortCards(sorted);
+    key = multisetRank[multisetIndex(sorted)] * spellings + spelled;
     return true;
 }
 
-int main() {
+// A ranked hand: its key above its bid, so sorting the records sorts by hand, then by bid
+using Record = uint64_t;
 
-    // read the lookup into map
-    std::vector<std::string> lines{};
-    if (!readFile(lookup, lines)) {
-        return EXIT_FAILURE;
+inline uint64_t bidOf(Record record) {
+    return record & UINT32_MAX;
+}
+
+// The hand spelled back from the low digits of its key
+inline std::string handOf(Record record) {
+    auto spelled = static_cast<uint32_t>(record >> 32) % spellings;
+    std::string hand(5, ' ');
+    for (auto it = hand.rbegin(); it != hand.rend(); ++it) {
+        *it = spellingOrder[spelled % 13];
+        spelled /= 13;
     }
+    return hand;
+}
 
-    // map = hashcode, rank
-    std::unordered_map<std::uint64_t, uint32_t> handLookup = {};
-    for (const auto &line: lines) {
-        std::istringstream iss{line};
+/*
+ * LSD radix sort digits of a record, low to high: the bid in three and the key in two, so the
+ * key and the bid never share a digit and sorting the key takes two passes
+ */
+constexpr std::array<std::pair<int, int>, 5> digits{{{0, 11}, {11, 11}, {22, 10}, {32, 16}, {48, 16}}};
+constexpr size_t buckets = size_t{1} << 16;
 
-        uint32_t rank;
-        std::string hand;
-        uint64_t hashcode;
+// below this much input the histograms cost more to clear and scan than a comparison sort
+constexpr size_t radixBytes = 1 << 20;
 
-        iss >> rank >> hand >> hashcode;
-        handLookup[hashcode] = rank;
+using Histogram = std::vector<size_t>;  // digits.size() x buckets
+
+inline void count(Record record, Histogram &counts) {
+    for (size_t d = 0; d < digits.size(); ++d) {
+        const auto [shift, bits] = digits[d];
+        ++counts[d * buckets + ((record >> shift) & ((Record{1} << bits) - 1))];
     }
+}
 
-    // read the text file
-    lines.clear();
-    if (!readFile(file1, lines)) {
-        return EXIT_FAILURE;
+// Sorts records whose digits were all counted; a pass whose digit is the same in every record
+// is skipped, which with small bids leaves three passes
+static void radixSort(std::vector<Record> &records, Histogram &counts) {
+    std::vector<Record> sorted(records.size());
+    for (size_t d = 0; d < digits.size(); ++d) {
+        const auto [shift, bits] = digits[d];
+        const auto mask = (Record{1} << bits) - 1;
+        auto *count = counts.data() + d * buckets;
+        if (std::any_of(count, count + buckets, [&records](size_t n) { return n == records.size(); })) {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < buckets; ++bucket) {
+            offset += std::exchange(count[bucket], offset);
+        }
+        for (const auto record: records) {
+            sorted[count[(record >> shift) & mask]++] = record;
+        }
+        records.swap(sorted);
     }
+}
 
-    std::vector<std::pair<std::string, uint64_t>> hands;
-    for (const auto & line : lines) {
-        std::istringstream iss{line};
-        std::string hand;
-        uint64_t bid;
-        iss >> hand >> bid;
-        hands.emplace_back(hand, bid);
+/*
+ * Hands and bids sorted from the weakest to the strongest hand; bids must fit 32 bits. Lines
+ * of five cards, a space and a bid are read straight from the text and, for a radix sort,
+ * counted as they go; any other line is left to handKey and parseIntegers, which report it.
+ */
+std::vector<Record> rankHands(std::string_view input) {
+    std::vector<Record> records;
+    records.reserve(input.size() / 8 + 1);  // a line is at least "AAAAA 1\n"
+    const bool radix = input.size() >= radixBytes;
+    Histogram counts(radix ? digits.size() * buckets : 0);
+    const auto add = [&records, &counts, radix](uint32_t key, uint32_t bid) {
+        const auto record = static_cast<Record>(key) << 32 | bid;
+        if (radix) {
+            count(record, counts);
+        }
+        records.push_back(record);
+    };
+
+    const char *p = input.data();
+    const char *end = p + input.size();
+    while (p < end) {
+        uint32_t key;
+        if (end - p > 6 && ' ' == p[5] && handKey({p, 5}, key)) {
+            const char *q = p + 6;
+            uint64_t bid = 0;
+            while (q < end && q - p < 16 && aoc::detail::isDigit(*q)) {
+                bid = bid * 10 + static_cast<uint64_t>(*q++ - '0');
+            }
+            if (q - p > 6 && q - p < 16 && bid <= UINT32_MAX && (q == end || '\n' == *q)) {
+                add(key, static_cast<uint32_t>(bid));
+                p = q + 1;
+                continue;
+            }
+        }
+        const auto *nl = static_cast<const char *>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        std::string_view line(p, static_cast<size_t>((nullptr == nl ? end : nl) - p));
+        p = nullptr == nl ? end : nl + 1;
+        if (!line.empty() && '\r' == line.back()) {
+            line.remove_suffix(1);
+        }
+        std::array<uint32_t, 1> bid{};
+        if (!handKey(line, key) || 1 != aoc::parseIntegers(line.substr(5), std::span(bid))) {
+            std::cerr << "Not a hand : " << line << std::endl;
+            continue;
+        }
+        add(key, bid[0]);
+    }
+    if (radix) {
+        radixSort(records, counts);
+    } else {
+        std::sort(records.begin(), records.end());
     }
+    return records;
+}
 
+aoc::Answer solvePart1(std::string_view input) {
+    uint64_t total = 0;
+    uint64_t index = 1;
+    for (const auto record: rankHands(input)) {
+        total += bidOf(record) * index;
+        index++;
+    }
+    return std::to_string(total);
+}
 
-    // Vector pairs to store ranks, hand, and bids
-    std::vector<std::tuple<uint64_t, std::string,uint64_t>> tuples;
+// Part 2 (jokers) has not been solved for this day
+aoc::Answer solvePart2(std::string_view) {
+    return {};
+}
 
-    // lookup the hand and create new tuples
-    for (auto & handPair : hands) {
-        std::string hand = handPair.first;
-        uint64_t bid = handPair.second;
+}  // namespace day7
 
-        uint64_t hashcode = hashHand(hand);
-        auto got = handLookup.find(hashcode);
-        if (got != handLookup.end()) {
-            tuples.emplace_back(got->second, hand, bid);
-        }
-        else {
-            std::cout << "Couldn't find hashcode : " << hand << ":" << hashcode << std::endl;
-        }
+#ifndef AOC_LIBRARY
+/*
+ * Usage: Day_7 [--quiet]
+ * Lists every hand in rank order with its winnings before the total, unless --quiet.
+ */
+int main(int argc, char *argv[]) {
+    const bool quiet = argc > 1 && std::string_view("--quiet") == argv[1];
+    if (argc > (quiet ? 2 : 1)) {
+        std::cerr << "Usage: " << argv[0] << " [--quiet]" << std::endl;
+        return EXIT_FAILURE;
     }
 
-    sort(tuples.begin(), tuples.end());
+    // read the text file
+    const aoc::MappedFile input(day7::file1);
+    if (!input) {
+        return EXIT_FAILURE;
+    }
 
     uint64_t total = 0;
-    int index = 1;
-    for (auto [ X, Y, Z ] : tuples) {
-        uint64_t value = Z * index;
-        std::cout << index << " : " << Y << " " << Z << " : " << Z * index << std::endl;
+    uint64_t index = 1;
+    for (const auto record: day7::rankHands(input.view())) {
+        const auto bid = day7::bidOf(record);
+        const uint64_t value = bid * index;
+        if (!quiet) {
+            std::cout << index << " : " << day7::handOf(record) << " " << bid << " : " << value << '\n';
+        }
         total += value;
         index++;
     }
     std::cout << "total : " << total << std::endl;
-}
\ No newline at end of file
+}
+#endif
@@ -1,134 +1,386 @@
 // Advent of Code 2023
-// Day 8:
-// https://adventofcode.com/2023/day/7
+// Day 8: Haunted Wasteland
+// https://adventofcode.com/2023/day/8
 
 #include <iostream>
 #include <string>
-#include <sstream>
 #include <vector>
-#include <fstream>
+#include <array>
 #include <cstdint>
-#include <map>
 #include <algorithm>
-#include <numeric>
+#include <span>
+#include <tuple>
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
 
 using namespace std;
 
-using Map = map<string, pair<string, string>>;
+namespace day8 {
 
-string file1 = "input2.txt";
+const string file1 = "input2.txt";
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
+__extension__ using u128 = unsigned __int128;
+
+constexpr uint32_t noNode = UINT32_MAX;
+constexpr uint32_t names = 36 * 36 * 36;
+
+// Base-36 code of a three-character name of digits and capitals, or `names` for anything else
+static uint32_t code(string_view name) {
+    uint32_t value = 0;
+    for (const char ch: name) {
+        if ('0' <= ch && ch <= '9') {
+            value = value * 36 + static_cast<uint32_t>(ch - '0');
+        } else if ('A' <= ch && ch <= 'Z') {
+            value = value * 36 + static_cast<uint32_t>(ch - 'A' + 10);
+        } else {
+            return names;
+        }
     }
+    return value;
+}
 
-    auto closeStream = [&in] {
-        in.close();
-    };
+/*
+ * The network with its node names interned to dense ids, in order of first mention, and the
+ * instructions as 0 for left and 1 for right. A node that is mentioned but never defined leads
+ * back to itself.
+ */
+struct Network {
+    vector<uint8_t> directions;
+    vector<string_view> name;          // by id
+    vector<array<uint32_t, 2>> next;   // left and right by id
 
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
+    uint32_t find(string_view node) const {
+        const auto it = std::find(name.begin(), name.end(), node);
+        return it == name.end() ? noNode : static_cast<uint32_t>(it - name.begin());
     }
+};
 
-    closeStream();
-    return true;
+static Network toNetwork(string_view input) {
+    Network network;
+    const auto lines = aoc::splitLines(input);
+    if (lines.empty()) {
+        return network;
+    }
+    for (const char direction: lines[0]) {
+        network.directions.push_back('L' == direction ? 0 : 1);
+    }
+
+    // names that are not three digits or capitals all share the one id past the codes
+    vector<uint32_t> ids(names + 1, noNode);
+    const auto intern = [&network, &ids](string_view node) {
+        auto &id = ids[code(node)];
+        if (noNode == id) {
+            id = static_cast<uint32_t>(network.name.size());
+            network.name.push_back(node);
+            network.next.push_back({id, id});
+        }
+        return id;
+    };
+    for (size_t i = 2; i < lines.size(); ++i) {
+        if (lines[i].size() < 15) {
+            continue;
+        }
+        const auto node = intern(lines[i].substr(0, 3));
+        const auto left = intern(lines[i].substr(7, 3));
+        const auto right = intern(lines[i].substr(12, 3));
+        network.next[node] = {left, right};
+    }
+    return network;
 }
 
-int main() {
+/*
+ * One whole pass of the instructions from every node: where it ends, and the steps 1..length
+ * into it at which an end node is reached, so that the walk only has to go pass by pass. The
+ * pass table is lifted to 2^k passes for positioning a ghost at any step in O(log steps).
+ */
+class Passes {
+public:
+    Passes(const Network &network, const vector<bool> &isEnd)
+            : length_(network.directions.size()), first_(network.name.size() + 1) {
+        const auto nodes = network.name.size();
+        vector<uint32_t> pass(nodes);
+        for (uint32_t start = 0; start < nodes; ++start) {
+            auto node = start;
+            for (uint64_t step = 0; step < length_; ++step) {
+                node = network.next[node][network.directions[step]];
+                if (isEnd[node]) {
+                    hits_.push_back(step + 1);
+                }
+            }
+            pass[start] = node;
+            first_[start + 1] = static_cast<uint32_t>(hits_.size());
+        }
+        lifted_.push_back(std::move(pass));
+        while (size_t{1} << lifted_.size() <= nodes) {
+            const auto &half = lifted_.back();
+            vector<uint32_t> twice(nodes);
+            for (size_t node = 0; node < nodes; ++node) {
+                twice[node] = half[half[node]];
+            }
+            lifted_.push_back(std::move(twice));
+        }
+    }
 
-    Map map;
+    uint64_t length() const {
+        return length_;
+    }
 
-    // read the lookup into map
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
-        return EXIT_FAILURE;
+    uint32_t pass(uint32_t node) const {
+        return lifted_[0][node];
     }
 
-    cout << "Day 8" << endl;
+    span<const uint64_t> hits(uint32_t node) const {
+        return span(hits_).subspan(first_[node], first_[node + 1] - first_[node]);
+    }
 
-    // read the map from the lines
-    for (uint32_t i = 2; i < lines.size(); ++i) {
-        auto nodeName = lines[i].substr(0, 3);
-        auto left = lines[i].substr(7, 3);
-        auto right = lines[i].substr(12, 3);
+    // The node at the start of pass `passes`, which must be below 2^levels
+    uint32_t at(uint32_t node, uint64_t passes) const {
+        for (size_t level = 0; passes != 0; ++level, passes >>= 1) {
+            if (passes & 1) {
+                node = lifted_[level][node];
+            }
+        }
+        return node;
+    }
 
-        map[nodeName] = pair(left, right);
+    // Whether a ghost from start is on an end node after `step` >= 1 steps
+    bool endsAt(uint32_t start, uint64_t step) const {
+        const auto hits = this->hits(at(start, (step - 1) / length_));
+        return binary_search(hits.begin(), hits.end(), (step - 1) % length_ + 1);
     }
 
-    {
-        if (lines[2].substr(0, 3) == "AAA") {
-            // PART 1
-            uint64_t count{};
+private:
+    uint64_t length_;
+    vector<uint32_t> first_;
+    vector<uint64_t> hits_;
+    vector<vector<uint32_t>> lifted_;
+};
 
-            string nodeName = "AAA";
-            do {
-                const auto direction = lines[0][count % lines[0].size()];
-                if ('L' == direction) {
-                    nodeName = map.at(nodeName).first;
-                } else {
-                    nodeName = map.at(nodeName).second;
-                }
-                count++;
-            } while (nodeName != "ZZZ");
+/*
+ * Where a ghost is on an end node: passes repeat once a pass starts on a node already seen, so
+ * from step tail on the end steps repeat every period, at the given residues; before that they
+ * are irregular. Passes are found with a seen-table stamped per ghost.
+ */
+struct Cycle {
+    uint64_t tail;      // first step of the periodic part
+    uint64_t period;
+    vector<uint64_t> residues;
+};
 
-            cout << "  Part 1" << endl;
-            cout << "    Steps required to reach ZZZ : " << count << endl;
+static Cycle cycleOf(const Passes &passes, uint32_t start, vector<pair<uint32_t, uint64_t>> &seen, uint32_t stamp) {
+    vector<uint32_t> path;
+    auto node = start;
+    while (seen[node].first != stamp) {
+        seen[node] = {stamp, path.size()};
+        path.push_back(node);
+        node = passes.pass(node);
+    }
+    const auto mu = seen[node].second;
+    const auto length = passes.length();
+    Cycle cycle{mu * length + 1, (path.size() - mu) * length, {}};
+    for (auto pass = mu; pass < path.size(); ++pass) {
+        for (const auto hit: passes.hits(path[pass])) {
+            cycle.residues.push_back((pass * length + hit) % cycle.period);
         }
     }
+    sort(cycle.residues.begin(), cycle.residues.end());
+    return cycle;
+}
+
+static u128 gcd(u128 a, u128 b) {
+    while (b != 0) {
+        a = exchange(b, a % b);
+    }
+    return a;
+}
 
-    {
-        if (lines[2].substr(0, 3) != "AAA") {
-            // PART 2
-            vector<string> nodes;
-            vector<string> endNodes;
+// x = a (mod m) and x = b (mod n) as x mod lcm(m, n), if they agree; lcm(m, n) must fit
+static bool crt(u128 a, u128 m, uint64_t b, uint64_t n, u128 &x) {
+    const auto g = static_cast<uint64_t>(gcd(static_cast<u128>(n), m));
+    const auto nm = static_cast<u128>(n / g);
+    const auto ar = a % n;
+    const auto diff = b >= ar ? b - ar : n - (ar - b);
+    if (diff % g != 0) {
+        return false;
+    }
+    // m / g has an inverse mod n / g, found with the extended Euclidean algorithm
+    __extension__ using i128 = __int128;
+    i128 r0 = static_cast<i128>(nm), r1 = static_cast<i128>((m / g) % nm);
+    i128 t0 = 0, t1 = 1;
+    while (r1 != 0) {
+        const auto q = r0 / r1;
+        r0 = exchange(r1, r0 - q * r1);
+        t0 = exchange(t1, t0 - q * t1);
+    }
+    const auto inverse = static_cast<u128>(t0 < 0 ? t0 + static_cast<i128>(nm) : t0);
+    const auto k = (static_cast<u128>(diff / g) % nm) * inverse % nm;
+    x = a + m * k;
+    return true;
+}
 
-            // store starting nodes and ending nodes
-            for (const auto &[node, _]: map) {
-                if (node[2] == 'A') {
-                    nodes.push_back(node);
-                }
-                if (node[2] == 'Z') {
-                    endNodes.push_back(node);
-                }
+static string toString(u128 value) {
+    string text;
+    do {
+        text.insert(text.begin(), static_cast<char>('0' + static_cast<int>(value % 10)));
+        value /= 10;
+    } while (value != 0);
+    return text;
+}
+
+aoc::Answer solvePart1(string_view input) {
+    const auto network = toNetwork(input);
+    const auto start = network.find("AAA");
+    if (noNode == start || network.directions.empty()) {
+        return {};
+    }
+    vector<bool> isEnd(network.name.size());
+    for (size_t node = 0; node < isEnd.size(); ++node) {
+        isEnd[node] = "ZZZ" == network.name[node];
+    }
+    const Passes passes(network, isEnd);
+
+    // a pass that starts on a node already passed through cannot reach ZZZ any more
+    auto node = start;
+    for (uint64_t pass = 0; pass <= network.name.size(); ++pass) {
+        if (const auto hits = passes.hits(node); !hits.empty()) {
+            return to_string(pass * passes.length() + hits.front());
+        }
+        node = passes.pass(node);
+    }
+    return {};
+}
+
+/*
+ * Every ghost is on an end node only at steps that are irregular before its tail and periodic
+ * after it. Steps before the last tail are tried one by one, those of the first ghost checked
+ * against the others by positioning them; after it the periodic constraints are combined by
+ * the Chinese Remainder Theorem, so cycles need not be aligned to step 0 and may have several
+ * end nodes. No answer if the ghosts never line up. If their constraints get out of hand the
+ * first ghost's end steps are tried in order up to a budget instead, and only if that fails
+ * too is the give-up reported on cerr, so it is not taken for ghosts that never line up.
+ */
+aoc::Answer solvePart2(string_view input) {
+    constexpr size_t maxCandidates = size_t{1} << 20;
+    const auto network = toNetwork(input);
+    if (network.directions.empty()) {
+        return {};
+    }
+    vector<uint32_t> starts;
+    vector<bool> isEnd(network.name.size());
+    for (uint32_t node = 0; node < isEnd.size(); ++node) {
+        if ('A' == network.name[node][2]) {
+            starts.push_back(node);
+        }
+        isEnd[node] = 'Z' == network.name[node][2];
+    }
+    if (starts.empty()) {
+        return {};
+    }
+    const Passes passes(network, isEnd);
+
+    vector<Cycle> cycles;
+    vector<pair<uint32_t, uint64_t>> seen(network.name.size(), {0, 0});
+    for (size_t ghost = 0; ghost < starts.size(); ++ghost) {
+        cycles.push_back(cycleOf(passes, starts[ghost], seen, static_cast<uint32_t>(ghost + 1)));
+    }
+    const auto tail = max_element(cycles.begin(), cycles.end(), [](const Cycle &a, const Cycle &b) {
+        return a.tail < b.tail;
+    })->tail;
+
+    // irregular steps, in order, until the first one all the ghosts share
+    auto node = starts[0];
+    for (uint64_t pass = 0; pass * passes.length() + 1 < tail; ++pass, node = passes.pass(node)) {
+        for (const auto hit: passes.hits(node)) {
+            const auto step = pass * passes.length() + hit;
+            if (step < tail && all_of(starts.begin() + 1, starts.end(),
+                                      [&passes, step](uint32_t start) { return passes.endsAt(start, step); })) {
+                return to_string(step);
             }
+        }
+    }
 
-            auto cycles = vector<uint64_t>(nodes.size(), 0);
-            uint64_t count{};
-
-            do {
-                const auto direction = lines[0][count % lines[0].size()];
-                for (uint64_t i = 0; i < nodes.size(); ++i) {
-                    if (cycles[i] > 0) {
-                        continue;
-                    }
-
-                    auto &nodeName = nodes[i];
-                    if ('L' == direction) {
-                        nodeName = map.at(nodeName).first;
-                    } else {
-                        nodeName = map.at(nodeName).second;
-                    }
-
-                    if (find(endNodes.begin(), endNodes.end(), nodeName) != endNodes.end()) {
-                        cycles[i] = count + 1;
-                    }
+    // When the constraints get out of hand, the first ghost's periodic end steps are tried in
+    // order against every cycle's residues, for a budget of passes and steps
+    const auto giveUp = [&](const char *reason) -> aoc::Answer {
+        auto node = starts[0];
+        size_t budget = maxCandidates;
+        for (uint64_t pass = 0; budget > 0; ++pass, node = passes.pass(node)) {
+            const auto hits = passes.hits(node);
+            for (const auto hit: hits) {
+                const auto step = pass * passes.length() + hit;
+                if (step >= tail && all_of(cycles.begin(), cycles.end(), [step](const Cycle &cycle) {
+                        return binary_search(cycle.residues.begin(), cycle.residues.end(), step % cycle.period);
+                    })) {
+                    return to_string(step);
                 }
-                count++;
-            } while (!all_of(cycles.begin(), cycles.end(), [](auto c) { return c > 0; }));
-
-            count = 1;
-            for (unsigned long long cycle : cycles) {
-                count =   lcm(count, cycle);
             }
+            budget -= min(budget, hits.size() + 1);
+        }
+        cerr << "Gave up: " << reason << endl;
+        return {};
+    };
 
-            cout << "  Part 2" << endl;
-            cout << "    Steps required to reach nodes ending in Z : " << count << endl;
+    // periodic steps: ghosts on the same cycle in the same phase add nothing
+    sort(cycles.begin(), cycles.end(), [](const Cycle &a, const Cycle &b) {
+        return tie(a.period, a.residues) < tie(b.period, b.residues);
+    });
+    cycles.erase(unique(cycles.begin(), cycles.end(), [](const Cycle &a, const Cycle &b) {
+        return a.period == b.period && a.residues == b.residues;
+    }), cycles.end());
+    u128 modulus = 1;
+    vector<u128> candidates{0};
+    for (const auto &cycle: cycles) {
+        const auto g = gcd(modulus, static_cast<u128>(cycle.period));
+        if (modulus / g > ~u128{0} / cycle.period) {
+            return giveUp("the ghosts' cycles have a common period past 128 bits");
+        }
+        vector<u128> combined;
+        for (const auto a: candidates) {
+            for (const auto b: cycle.residues) {
+                if (u128 x; crt(a, modulus, b, cycle.period, x)) {
+                    combined.push_back(x);
+                }
+            }
+        }
+        sort(combined.begin(), combined.end());
+        combined.erase(unique(combined.begin(), combined.end()), combined.end());
+        if (combined.size() > maxCandidates) {
+            return giveUp("too many candidate steps for the ghosts to line up");
         }
+        if (combined.empty()) {
+            return {};
+        }
+        candidates = std::move(combined);
+        modulus = modulus / g * cycle.period;
+    }
+    u128 first = ~u128{0};
+    for (const auto candidate: candidates) {
+        first = min(first, tail + (candidate + modulus - tail % modulus) % modulus);
+    }
+    return toString(first);
+}
+
+}  // namespace day8
+
+#ifndef AOC_LIBRARY
+int main() {
+
+    const aoc::MappedFile input(day8::file1);
+    if (!input) {
+        return EXIT_FAILURE;
+    }
+
+    cout << "Day 8" << endl;
+
+    // the samples only have one of the two parts
+    if (const auto steps = day8::solvePart1(input.view()); !steps.empty()) {
+        cout << "  Part 1" << endl;
+        cout << "    Steps required to reach ZZZ : " << steps << endl;
     }
 
+    cout << "  Part 2" << endl;
+    cout << "    Steps required to reach nodes ending in Z : " << day8::solvePart2(input.view()) << endl;
+
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
+#endif
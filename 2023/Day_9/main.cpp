@@ -24,109 +24,212 @@
 // https://adventofcode.com/2023/day/9
 
 #include <algorithm>
-#include <fstream>
 #include <iostream>
-#include <sstream>
+#include <array>
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <numeric>
+#include "../Common/Input.h"
+#include "../Common/Parse.h"
+#include "../Common/Solver.h"
+#include "../Common/ThreadPool.h"
 
 using namespace std;
 
-const string file1 = "input.txt";
+namespace day9 {
 
-static bool readFile(const string &fileName, vector<string> &lines) {
-    ifstream in(fileName);
-    if (!in) {
-        cerr << "Cannot open file " << fileName << endl;
-        return false;
-    }
+const string file1 = "input.txt";
 
-    auto closeStream = [&in] {
-        in.close();
-    };
+__extension__ using i128 = __int128;
+__extension__ using u128 = unsigned __int128;
 
-    string str;
-    while (getline(in, str)) {
-        lines.push_back(str);
-    }
+// C(64, 32) still fits a 64-bit weight; longer lines take a difference table instead
+constexpr size_t maxValues = 64;
 
-    closeStream();
-    return true;
-}
-
-int main() {
+// a chunk this small is not worth a thread
+constexpr size_t bytesPerChunk = 1 << 20;
 
-    cout << "Day 9" << endl;
-
-    vector<string> lines{};
-    if (!readFile(file1, lines)) {
-        return EXIT_FAILURE;
+/*
+ * A sequence of n values whose differences die out within n rows is a polynomial of degree below
+ * n, so both of its neighbours are fixed integer combinations of its values:
+ *   next     = sum over i of (-1)^(n-1-i) C(n, i)   x[i]
+ *   previous = sum over i of (-1)^i       C(n, i+1) x[i]
+ * The weights are the same for every sequence of the same length, so the extrapolations of all
+ * the lines add up to the weights applied to the column sums of the lines of each length.
+ */
+struct Weights {
+    array<array<int64_t, maxValues>, maxValues + 1> next{};
+    array<array<int64_t, maxValues>, maxValues + 1> previous{};
+};
+
+constexpr Weights weights = [] {
+    array<array<int64_t, maxValues + 1>, maxValues + 1> binomial{};
+    for (size_t n = 0; n <= maxValues; ++n) {
+        binomial[n][0] = 1;
+        for (size_t k = 1; k <= n; ++k) {
+            binomial[n][k] = binomial[n - 1][k - 1] + (k < n ? binomial[n - 1][k] : 0);
+        }
     }
+    Weights w;
+    for (size_t n = 1; n <= maxValues; ++n) {
+        for (size_t i = 0; i < n; ++i) {
+            w.next[n][i] = (n - 1 - i) % 2 ? -binomial[n][i] : binomial[n][i];
+            w.previous[n][i] = i % 2 ? -binomial[n][i + 1] : binomial[n][i + 1];
+        }
+    }
+    return w;
+}();
 
-
-    {
-        // Part 1
-        uint64_t sum {};
-        for (const auto& line : lines) {
-            vector<int> data;
-            vector<int> lasts;
-
-            int x;
-            istringstream iss(line);
-            while (iss >> x) {
-                data.push_back(x);
+/*
+ * Column sums of the lines of each length. Lines whose values all fit 32 bits go to 64-bit sums,
+ * which a chunk cannot overflow, in a loop the compiler vectorises; any other line goes
+ * straight to the exact 128-bit sums. Lines of more than maxValues values are extrapolated on
+ * their own, by a difference table in wrapping 128-bit arithmetic: it only adds and subtracts,
+ * so the totals are still exact whenever they fit.
+ */
+struct Columns {
+    array<array<int64_t, maxValues>, maxValues + 1> small{};
+    array<array<i128, maxValues>, maxValues + 1> large{};
+    u128 longNext{};
+    u128 longPrevious{};
+
+    void add(const int64_t *values, size_t n) {
+        uint64_t magnitudes = 0;
+        for (size_t i = 0; i < n; ++i) {
+            magnitudes |= static_cast<uint64_t>(values[i] ^ (values[i] >> 63));
+        }
+        if (magnitudes >> 31) {
+            for (size_t i = 0; i < n; ++i) {
+                large[n][i] += values[i];
             }
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                small[n][i] += values[i];
+            }
+        }
+    }
 
-            lasts.push_back(data.back());
-            do {
-                adjacent_difference(data.begin(), data.end(), data.begin());
-                lasts.push_back(data.back());
-                data.erase(data.begin());
-
-            } while (!all_of(data.begin(),data.end(), [](auto d) { return d == 0;}));
+    void addLong(vector<u128> &row) {
+        for (size_t length = row.size(), depth = 0; length > 0; --length, ++depth) {
+            longNext += row[length - 1];
+            longPrevious += depth % 2 ? -row[0] : row[0];
+            for (size_t i = 0; i + 1 < length; ++i) {
+                row[i] = row[i + 1] - row[i];
+            }
+        }
+    }
 
-            for (const auto& last : lasts) {
-                sum += last;
+    void add(const Columns &other) {
+        longNext += other.longNext;
+        longPrevious += other.longPrevious;
+        for (size_t n = 1; n <= maxValues; ++n) {
+            for (size_t i = 0; i < n; ++i) {
+                large[n][i] += static_cast<i128>(other.small[n][i]) + other.large[n][i];
             }
         }
+    }
+};
+
+static Columns scanChunk(string_view text) {
+    Columns columns;
+    array<int64_t, maxValues> values{};
+    vector<int64_t> longValues;
+    vector<u128> row;
+    aoc::forEachLine(text, [&](string_view line) {
+        const auto n = aoc::parseIntegers(line, span(values));
+        if (n <= values.size()) {
+            columns.add(values.data(), n);
+            return;
+        }
+        longValues.resize(n);
+        aoc::parseIntegers(line, span(longValues));
+        row.assign(longValues.size(), 0);
+        transform(longValues.begin(), longValues.end(), row.begin(),
+                  [](int64_t value) { return static_cast<u128>(static_cast<i128>(value)); });
+        columns.addLong(row);
+    });
+    return columns;
+}
+
+struct Totals {
+    i128 next{};      // sum of the values after each line
+    i128 previous{};  // sum of the values before each line
+};
 
-        cout << "  Part 1" << endl;
-        cout << "     Sum of right extrapolated values : " << sum << endl;
+/*
+ * Both extrapolations in one pass over the input, split into newline-aligned chunks that are
+ * scanned in parallel once it is large enough to be worth it. Exact as long as the totals fit
+ * 128 bits.
+ */
+static Totals extrapolate(string_view input) {
+    const auto chunks = max<size_t>(1, input.size() / bytesPerChunk);
+    vector<string_view> parts;
+    size_t begin = 0;
+    for (size_t i = 1; i <= chunks && begin < input.size(); ++i) {
+        const auto nl = input.find('\n', max(begin, input.size() * i / chunks));
+        const auto end = string_view::npos == nl ? input.size() : nl + 1;
+        parts.push_back(input.substr(begin, end - begin));
+        begin = end;
+    }
+    vector<Columns> partial(parts.size());
+    aoc::ThreadPool::global().parallelFor(parts.size(), [&](size_t part) {
+        partial[part] = scanChunk(parts[part]);
+    });
+    Columns columns;
+    for (const auto &part: partial) {
+        columns.add(part);
+    }
 
+    Totals totals{static_cast<i128>(columns.longNext), static_cast<i128>(columns.longPrevious)};
+    for (size_t n = 1; n <= maxValues; ++n) {
+        for (size_t i = 0; i < n; ++i) {
+            totals.next += weights.next[n][i] * columns.large[n][i];
+            totals.previous += weights.previous[n][i] * columns.large[n][i];
+        }
     }
+    return totals;
+}
 
-    {  // Part 2
-        uint64_t sum {};
+static string toString(i128 value) {
+    const bool negative = value < 0;
+    auto magnitude = negative ? -static_cast<unsigned __int128>(value) : static_cast<unsigned __int128>(value);
+    string text;
+    do {
+        text.insert(text.begin(), static_cast<char>('0' + static_cast<int>(magnitude % 10)));
+        magnitude /= 10;
+    } while (magnitude != 0);
+    return negative ? '-' + text : text;
+}
 
-        for (const auto& line : lines) {
-            vector<int> data;
-            vector<int> firsts;
+aoc::Answer solvePart1(string_view input) {
+    return toString(extrapolate(input).next);
+}
 
-            int x;
-            istringstream iss(line);
-            while (iss >> x) {
-                data.push_back(x);
-            }
+aoc::Answer solvePart2(string_view input) {
+    return toString(extrapolate(input).previous);
+}
 
-            do {
-                firsts.push_back(data.front());
-                adjacent_difference(data.begin(), data.end(), data.begin());
+}  // namespace day9
 
-                data.erase(data.begin());
+#ifndef AOC_LIBRARY
+int main() {
 
-            } while (!all_of(data.begin(),data.end(), [](auto d) { return d == 0;}));
+    cout << "Day 9" << endl;
 
-            int first{};
-            for (size_t i = firsts.size(); i > 0; --i) {
-                first = firsts[i -1] - first;
-            }
-            sum += first;
-        }
-        cout << "  Part 2" << endl;
-        cout << "     Sum of left extrapolated values : " << sum << endl;
+    const aoc::MappedFile input(day9::file1);
+    if (!input) {
+        return EXIT_FAILURE;
     }
 
+    // one pass gives both parts
+    const auto totals = day9::extrapolate(input.view());
+
+    cout << "  Part 1" << endl;
+    cout << "     Sum of right extrapolated values : " << day9::toString(totals.next) << endl;
+
+    cout << "  Part 2" << endl;
+    cout << "     Sum of left extrapolated values : " << day9::toString(totals.previous) << endl;
+
     return EXIT_SUCCESS;
 }
+#endif
@@ -0,0 +1,395 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// Poker hand evaluator: five and seven cards, every table built at compile time
+
+#ifndef AOC_POKER2_POKER_H
+#define AOC_POKER2_POKER_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace poker {
+
+/*
+ * A card packed the Cactus Kev way, so that a hand is classified from a few ANDs, ORs and one
+ * product of its cards:
+ *   bits 16-28  one bit for the rank, deuce lowest
+ *   bits 12-15  one bit for the suit
+ *   bits  8-11  the rank, 0 to 12
+ *   bits  0- 7  the rank's prime, 2 to 41
+ */
+using Card = uint32_t;
+using Hand = std::array<Card, 5>;
+using Hand7 = std::array<Card, 7>;
+
+// Strength of a hand, 0 for the weakest high card to 7461 for a royal flush; equal is a split pot
+using Value = uint16_t;
+
+constexpr std::string_view ranks = "23456789TJQKA";
+constexpr std::string_view suits = "cdhs";
+constexpr std::array<uint32_t, 13> primes{2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41};
+
+constexpr Card makeCard(int rank, int suit) {
+    return uint32_t{1} << (16 + rank) | uint32_t{1} << (12 + suit) | static_cast<uint32_t>(rank) << 8 |
+           primes[static_cast<size_t>(rank)];
+}
+
+// "As", "Td", ... or 0 if the text is not a card
+constexpr Card parseCard(std::string_view text) {
+    if (text.size() != 2 || ranks.find(text[0]) == std::string_view::npos ||
+        suits.find(text[1]) == std::string_view::npos) {
+        return 0;
+    }
+    return makeCard(static_cast<int>(ranks.find(text[0])), static_cast<int>(suits.find(text[1])));
+}
+
+enum class Category : uint8_t {
+    HighCard, Pair, TwoPair, Trips, Straight, Flush, FullHouse, Quads, StraightFlush
+};
+
+// First value of each category; a category is worth everything up to the next one
+constexpr std::array<Value, 10> categoryStart{0, 1277, 4137, 4995, 5853, 5863, 7140, 7296, 7452, 7462};
+constexpr size_t values = categoryStart.back();
+
+constexpr Category category(Value value) {
+    return static_cast<Category>(std::upper_bound(categoryStart.begin(), categoryStart.end(), value) -
+                                 categoryStart.begin() - 1);
+}
+
+constexpr std::string_view categoryName(Category category) {
+    constexpr std::array<std::string_view, 9> names{
+            "High card", "Pair", "Two pair", "Three of a kind", "Straight",
+            "Flush", "Full house", "Four of a kind", "Straight flush"};
+    return names[static_cast<size_t>(category)];
+}
+
+namespace detail {
+
+constexpr Value none = UINT16_MAX;
+constexpr size_t repeatedHands = 4888;  // rank multisets of five with a pair or better, none of them five of a kind
+
+// Every value, found from the cards' rank bits when the ranks are all different and from the
+// product of their primes, which is the same for every order of the same ranks, when they are not
+struct Tables {
+    std::array<Value, 8192> flush{};     // five ranks of one suit
+    std::array<Value, 8192> distinct{};  // five ranks, not of one suit; none if fewer ranks
+    std::array<uint32_t, repeatedHands> products{};
+    std::array<Value, repeatedHands> repeated{};
+};
+
+// Calls f(a, b, c, d, e) for five different ranks, a highest, in ascending order of hands that do
+// not make a straight
+template <typename F>
+constexpr void forEachHighCard(F f) {
+    for (int a = 5; a < 13; ++a) {
+        for (int b = 3; b < a; ++b) {
+            for (int c = 2; c < b; ++c) {
+                for (int d = 1; d < c; ++d) {
+                    for (int e = 0; e < d; ++e) {
+                        if (4 != a - e && !(12 == a && 3 == b)) {
+                            f(a, b, c, d, e);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// The rank bits of the ten straights in ascending order, the wheel A2345 first
+template <typename F>
+constexpr void forEachStraight(F f) {
+    f(0x100Fu);
+    for (int top = 4; top < 13; ++top) {
+        f(0x1Fu << (top - 4));
+    }
+}
+
+constexpr uint32_t bit(int rank) {
+    return uint32_t{1} << rank;
+}
+
+constexpr uint32_t prime(int rank) {
+    return primes[static_cast<size_t>(rank)];
+}
+
+/*
+ * Hands are numbered category by category from high card up, each category in ascending order
+ * of its largest group, then the next, and so on, which is the order the loops run in.
+ */
+constexpr Tables buildTables() {
+    Tables tables{};
+    tables.distinct.fill(none);
+    Value next = 0;
+    size_t repeated = 0;
+    const auto add = [&tables, &next, &repeated](uint32_t product) {
+        tables.products[repeated] = product;
+        tables.repeated[repeated++] = next++;
+    };
+
+    forEachHighCard([&tables, &next](int a, int b, int c, int d, int e) {
+        tables.distinct[bit(a) | bit(b) | bit(c) | bit(d) | bit(e)] = next++;
+    });
+    for (int p = 0; p < 13; ++p) {
+        for (int a = 2; a < 13; ++a) {
+            for (int b = 1; b < a; ++b) {
+                for (int c = 0; c < b; ++c) {
+                    if (p != a && p != b && p != c) {
+                        add(prime(p) * prime(p) * prime(a) * prime(b) * prime(c));
+                    }
+                }
+            }
+        }
+    }
+    for (int h = 1; h < 13; ++h) {
+        for (int l = 0; l < h; ++l) {
+            for (int k = 0; k < 13; ++k) {
+                if (h != k && l != k) {
+                    add(prime(h) * prime(h) * prime(l) * prime(l) * prime(k));
+                }
+            }
+        }
+    }
+    for (int t = 0; t < 13; ++t) {
+        for (int a = 1; a < 13; ++a) {
+            for (int b = 0; b < a; ++b) {
+                if (t != a && t != b) {
+                    add(prime(t) * prime(t) * prime(t) * prime(a) * prime(b));
+                }
+            }
+        }
+    }
+    forEachStraight([&tables, &next](uint32_t bits) { tables.distinct[bits] = next++; });
+    forEachHighCard([&tables, &next](int a, int b, int c, int d, int e) {
+        tables.flush[bit(a) | bit(b) | bit(c) | bit(d) | bit(e)] = next++;
+    });
+    for (int t = 0; t < 13; ++t) {
+        for (int p = 0; p < 13; ++p) {
+            if (t != p) {
+                add(prime(t) * prime(t) * prime(t) * prime(p) * prime(p));
+            }
+        }
+    }
+    for (int q = 0; q < 13; ++q) {
+        for (int k = 0; k < 13; ++k) {
+            if (q != k) {
+                add(prime(q) * prime(q) * prime(q) * prime(q) * prime(k));
+            }
+        }
+    }
+    forEachStraight([&tables, &next](uint32_t bits) { tables.flush[bits] = next++; });
+    return tables;
+}
+
+constexpr Tables tables = buildTables();
+
+/*
+ * Minimal perfect hash of the 4888 prime products onto 0..4887, hash and displace style: the
+ * top bits of a multiplicative hash pick one of 4096 buckets, the middle bits a home slot, and
+ * every key of a bucket moves on from its home by the bucket's displacement. The buckets are
+ * placed largest first, each at the first displacement that lands all its keys on free slots,
+ * and the many single keys simply on the next free slot. Every product that five cards can make
+ * is a key, so a lookup never has to check it hit one.
+ */
+class PerfectHash {
+public:
+    static constexpr int bucketBits = 12;
+    static constexpr size_t buckets = size_t{1} << bucketBits;
+    static constexpr size_t size = repeatedHands;
+
+    constexpr PerfectHash() {
+        // odd multipliers tried in turn until the keys of every bucket have different homes
+        for (uint64_t seed = 0x9E3779B97F4A7C15;; seed += 0x6A09E667F3BCC90A) {
+            multiplier = seed | 1;
+            if (place()) {
+                return;
+            }
+        }
+    }
+
+    constexpr Value operator()(uint32_t product) const {
+        const uint64_t mixed = product * multiplier;
+        return values[wrap(homeOf(mixed) + displacement[bucketOf(mixed)])];
+    }
+
+private:
+    static constexpr size_t bucketOf(uint64_t mixed) {
+        return static_cast<size_t>(mixed >> (64 - bucketBits));
+    }
+
+    static constexpr size_t homeOf(uint64_t mixed) {
+        return static_cast<size_t>(((mixed >> 16) & UINT32_MAX) * size >> 32);
+    }
+
+    static constexpr size_t wrap(size_t position) {
+        return position < size ? position : position - size;
+    }
+
+    constexpr bool place() {
+        // keys grouped by bucket, and the buckets ordered largest first, both by counting sort
+        std::array<uint16_t, size> home{};
+        std::array<uint16_t, buckets + 1> first{};
+        for (size_t key = 0; key < size; ++key) {
+            const uint64_t mixed = tables.products[key] * multiplier;
+            home[key] = static_cast<uint16_t>(homeOf(mixed));
+            ++first[bucketOf(mixed) + 1];
+        }
+        size_t largest = 0;
+        for (size_t bucket = 0; bucket < buckets; ++bucket) {
+            largest = std::max<size_t>(largest, first[bucket + 1]);
+            first[bucket + 1] = static_cast<uint16_t>(first[bucket + 1] + first[bucket]);
+        }
+        std::array<uint16_t, size> keys{};
+        auto fill = first;
+        for (size_t key = 0; key < size; ++key) {
+            keys[fill[bucketOf(tables.products[key] * multiplier)]++] = static_cast<uint16_t>(key);
+        }
+
+        displacement.fill(0);
+        std::array<bool, size> taken{};
+        size_t nextFree = 0;
+        for (size_t length = largest; length > 0; --length) {
+            for (size_t bucket = 0; bucket < buckets; ++bucket) {
+                if (static_cast<size_t>(first[bucket + 1] - first[bucket]) != length) {
+                    continue;
+                }
+                const auto begin = keys.begin() + first[bucket];
+                const auto end = keys.begin() + first[bucket + 1];
+                const auto lands = [&](size_t shift) {
+                    return std::none_of(begin, end, [&](uint16_t key) { return taken[wrap(home[key] + shift)]; });
+                };
+                size_t shift = size;
+                if (1 == length) {
+                    while (taken[nextFree]) {
+                        ++nextFree;
+                    }
+                    shift = wrap(nextFree + size - home[*begin]);
+                } else {
+                    for (auto it = begin; it != end; ++it) {
+                        if (std::any_of(begin, it, [&](uint16_t other) { return home[other] == home[*it]; })) {
+                            return false;
+                        }
+                    }
+                    shift = 0;
+                    while (shift < size && !lands(shift)) {
+                        ++shift;
+                    }
+                    if (size == shift) {
+                        return false;
+                    }
+                }
+                displacement[bucket] = static_cast<uint16_t>(shift);
+                for (auto it = begin; it != end; ++it) {
+                    taken[wrap(home[*it] + shift)] = true;
+                    values[wrap(home[*it] + shift)] = tables.repeated[*it];
+                }
+            }
+        }
+        return true;
+    }
+
+    uint64_t multiplier = 0;
+    std::array<uint16_t, buckets> displacement{};
+    std::array<Value, size> values{};
+};
+
+constexpr PerfectHash repeated{};
+
+// The 21 ways of keeping five of seven cards
+constexpr auto fiveOfSeven = [] {
+    std::array<std::array<uint8_t, 5>, 21> ways{};
+    size_t way = 0;
+    for (uint8_t skip1 = 0; skip1 < 7; ++skip1) {
+        for (uint8_t skip2 = skip1 + 1; skip2 < 7; ++skip2) {
+            size_t kept = 0;
+            for (uint8_t card = 0; card < 7; ++card) {
+                if (card != skip1 && card != skip2) {
+                    ways[way][kept++] = card;
+                }
+            }
+            ++way;
+        }
+    }
+    return ways;
+}();
+
+}  // namespace detail
+
+constexpr Value evaluate(const Hand &hand) {
+    const auto [a, b, c, d, e] = hand;
+    const uint32_t bits = (a | b | c | d | e) >> 16;
+    if (a & b & c & d & e & 0xF000) {
+        return detail::tables.flush[bits];
+    }
+    if (const auto value = detail::tables.distinct[bits]; value != detail::none) {
+        return value;
+    }
+    return detail::repeated((a & 0xFF) * (b & 0xFF) * (c & 0xFF) * (d & 0xFF) * (e & 0xFF));
+}
+
+// The best five of seven cards
+constexpr Value evaluate(const Hand7 &hand) {
+    Value best = 0;
+    for (const auto &way: detail::fiveOfSeven) {
+        best = std::max(best, evaluate(Hand{hand[way[0]], hand[way[1]], hand[way[2]], hand[way[3]], hand[way[4]]}));
+    }
+    return best;
+}
+
+/*
+ * Batches: no hand waits on another, so the table loads of consecutive hands overlap instead
+ * of each paying its own cache miss. values must be as long as hands.
+ */
+inline void evaluate(std::span<const Hand> hands, std::span<Value> values) {
+    for (size_t i = 0; i < hands.size(); ++i) {
+        values[i] = evaluate(hands[i]);
+    }
+}
+
+inline void evaluate(std::span<const Hand7> hands, std::span<Value> values) {
+    for (size_t i = 0; i < hands.size(); ++i) {
+        values[i] = evaluate(hands[i]);
+    }
+}
+
+inline std::vector<Value> evaluate(std::span<const Hand> hands) {
+    std::vector<Value> values(hands.size());
+    evaluate(hands, std::span(values));
+    return values;
+}
+
+inline std::vector<Value> evaluate(std::span<const Hand7> hands) {
+    std::vector<Value> values(hands.size());
+    evaluate(hands, std::span(values));
+    return values;
+}
+
+}  // namespace poker
+
+#endif  // AOC_POKER2_POKER_H
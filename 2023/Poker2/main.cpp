@@ -1,183 +1,130 @@
+// Poker hand evaluator, see Poker.h: checks it against the known number of hands of every
+// category among all 2,598,960 five-card hands and measures how many hands a second it rates
+//
+// Usage: Poker2 [--reps <n>] [--seven <n>]
+//   --reps times n passes over every five-card hand and reports the best (default 3)
+//   --seven also times n random seven-card hands
+
 #include <algorithm>
 #include <array>
-#include <cctype>
-#include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <random>
+#include <span>
 #include <string>
 #include <vector>
-#include <cstdint>
-#include <cassert>
-#include <sstream>
-#include <set>
+#include "Poker.h"
 
 using namespace std;
 
-vector<uint64_t> allHands = {};
-set<uint64_t> mySet = {};
-
-vector<uint64_t> fourOfAKind = {};
-vector<uint64_t> fullHouse = {};
-vector<uint64_t> straight = {};
-vector<uint64_t> threeOfAKind = {};
-
-// Prime values for card ranks
-const int primes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41 };
-
-// Hashing function using prime numbers for card ranks
-uint64_t hashHand(const vector<int>& hand) {
-    uint64_t hashValue = 1; // Initialize with 1 to avoid hashValue being 0
-    for (int card : hand) {
-        if (card >= 2 && card <= 14) {
-            hashValue *= primes[card - 2];
+// The 52 cards, and every way of choosing five of them
+static vector<poker::Hand> allHands() {
+    array<poker::Card, 52> deck{};
+    for (int rank = 0; rank < 13; ++rank) {
+        for (int suit = 0; suit < 4; ++suit) {
+            deck[static_cast<size_t>(rank * 4 + suit)] = poker::makeCard(rank, suit);
         }
     }
-    return hashValue;
-}
-
-// Function to generate Four of a Kind
-void generateFourOfAKind() {
-
-    // for all card types
-    for (int j = 2; j <= 14; j++) {
-        auto hand = vector<int>{};
-        hand.reserve(5);
-
-        // generate 4 cards
-        for (int i = 0; i < 4; ++i) {
-            hand.push_back(j);
-        }
-        // generate the 5th card
-        for (int k = 2; k<= 14; ++k) {
-            if (k!=j) {
-                hand.push_back(k);
-                uint64_t hashValue = hashHand(hand);
-                fourOfAKind.push_back(hashValue);
-
-                // all of them
-                allHands.push_back(hashValue);
-                mySet.insert(hashValue);
-
-                hand.pop_back();
+    vector<poker::Hand> hands;
+    hands.reserve(2598960);
+    for (size_t a = 0; a < deck.size(); ++a) {
+        for (size_t b = a + 1; b < deck.size(); ++b) {
+            for (size_t c = b + 1; c < deck.size(); ++c) {
+                for (size_t d = c + 1; d < deck.size(); ++d) {
+                    for (size_t e = d + 1; e < deck.size(); ++e) {
+                        hands.push_back({deck[a], deck[b], deck[c], deck[d], deck[e]});
+                    }
+                }
             }
         }
     }
+    return hands;
 }
 
-// Function to generate Full House
-void generateFullHouse() {
-
-    // for all card types
-    for (int j = 2; j <= 14; j++) {
-        auto hand = vector<int>{};
-        hand.reserve(5);
-
-        // generate 3 cards
-        for (int i = 0; i < 3; ++i) {
-            hand.push_back(j);
-        }
-        // generate the other 2 cards
-        for (int k = 2; k<= 14; ++k) {
-            if (k!=j) {
-                hand.push_back(k);
-                hand.push_back(k);
-                uint64_t hashValue = hashHand(hand);
-                fullHouse.push_back(hashValue);
-
-                // all of them
-                allHands.push_back(hashValue);
-                mySet.insert(hashValue);
-
-                hand.pop_back();
-                hand.pop_back();
-            }
-        }
+// Hands of each category among all five-card hands, and how many values each one spans
+static bool check(const vector<poker::Value> &values) {
+    constexpr array<uint64_t, 9> expected{1302540, 1098240, 123552, 54912, 10200, 5108, 3744, 624, 40};
+    array<uint64_t, 9> counts{};
+    vector<bool> seen(poker::values);
+    for (const auto value: values) {
+        ++counts[static_cast<size_t>(poker::category(value))];
+        seen[value] = true;
+    }
+    bool ok = static_cast<size_t>(count(seen.begin(), seen.end(), true)) == poker::values;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        const auto category = static_cast<poker::Category>(i);
+        cout << "    " << counts[i] << " : " << poker::categoryName(category) << endl;
+        ok = ok && counts[i] == expected[i];
     }
+    cout << "    " << count(seen.begin(), seen.end(), true) << " : Distinct values" << endl;
+    return ok;
 }
 
-// Function to generate straights
-void generateStraights() {
-
-    // ace low straight
-    vector<int> aceLow = {2,3,4,5,14};
-    straight.push_back(hashHand(aceLow));
-
-    // for all card types except 2
-    for (int j = 2; j <= 10; j++) {
-        vector<int> hand = {j,j+1,j+2,j+3,j+4};
-        uint64_t hashValue = hashHand(hand);
-        straight.push_back(hashValue);
-
-        // all of them
-        allHands.push_back(hashValue);
-        mySet.insert(hashValue);
+// Best of `reps` timed batch evaluations of hands, in hands/s
+template <typename Hand>
+static double handsPerSecond(const vector<Hand> &hands, vector<poker::Value> &values, uint64_t reps) {
+    double best{};
+    for (uint64_t rep = 0; rep < reps; ++rep) {
+        const auto start = chrono::steady_clock::now();
+        poker::evaluate(span<const Hand>(hands), span(values));
+        const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        best = max(best, static_cast<double>(hands.size()) / elapsed.count());
     }
+    return best;
 }
 
-// Function to generate trips
-void generateTrips() {
-
-    // for all card types
-    for (int j = 2; j <= 14; j++) {
-        auto hand = vector<int>{};
-        hand.reserve(5);
-
-        // generate 3 cards
-        for (int i = 0; i < 3; ++i) {
-            hand.push_back(j);
-        }
-        // generate the other 2 cards
-        for (int k = 2; k<= 14; ++k) {
-            for (int m = k+1; m<= 14; ++m) {
-                if (k != j && m != j) {
-                    hand.push_back(k);
-                    hand.push_back(m);
-                    uint64_t hashValue = hashHand(hand);
-                    threeOfAKind.push_back(hashValue);
-
-                    // all of them
-                    allHands.push_back(hashValue);
-                    mySet.insert(hashValue);
-
-                    hand.pop_back();
-                    hand.pop_back();
-                }
-            }
+// n seven-card hands dealt from a shuffled deck
+static vector<poker::Hand7> randomHands7(uint64_t n) {
+    mt19937_64 rng(n);
+    array<poker::Card, 52> deck{};
+    for (size_t card = 0; card < deck.size(); ++card) {
+        deck[card] = poker::makeCard(static_cast<int>(card / 4), static_cast<int>(card % 4));
+    }
+    vector<poker::Hand7> hands(n);
+    for (auto &hand: hands) {
+        for (size_t i = 0; i < hand.size(); ++i) {
+            swap(deck[i], deck[i + rng() % (deck.size() - i)]);
+            hand[i] = deck[i];
         }
     }
+    return hands;
 }
 
-int main() {
-    // Generate Four of a Kind
-    generateFourOfAKind();
-    cout << fourOfAKind.size() << " : Hash values of Four of a Kind " << endl;
-    //for (uint64_t hv : fourOfAKind) {
-    //    cout << hv << endl;
-    //}
-
-    // Generate Full House
-    generateFullHouse();
-    cout << fullHouse.size() << " : Hash values of Full House " << endl;
-    //for (uint64_t hv : fullHouse) {
-    //    cout << hv << endl;
-    //}
+int main(int argc, char *argv[]) {
+    uint64_t reps = 3;
+    uint64_t sevens{};
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        if ("--reps" == arg && i + 1 < argc) {
+            reps = max<uint64_t>(1, stoull(argv[++i]));
+        } else if ("--seven" == arg && i + 1 < argc) {
+            sevens = stoull(argv[++i]);
+        } else {
+            cerr << "Usage: " << argv[0] << " [--reps <n>] [--seven <n>]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
 
-    // Generate straight
-    generateStraights();
-    cout <<  straight.size() << " : Hash values of Straight " << endl;
-    //for (uint64_t hv : straights) {
-    //    cout << hv << endl;
-    //}
+    cout << "Poker hands" << endl;
 
-    // Generate 3 of a kind
-    generateTrips();
-    cout <<  threeOfAKind.size() << " : Hash values of Trips " << endl;
-    //for (uint64_t hv : threeOfAKind) {
-    //    cout << hv << endl;
-    //}
+    const auto hands = allHands();
+    vector<poker::Value> values(hands.size());
+    const auto rate = handsPerSecond(hands, values, reps);
+    cout << "  Five cards" << endl;
+    if (!check(values)) {
+        cerr << "Wrong number of hands of some category" << endl;
+        return EXIT_FAILURE;
+    }
+    cout << "    " << static_cast<uint64_t>(rate) << " hands/s" << endl;
 
-    // Summary
-    cout << "size of All hands : " << allHands.size() << endl;
-    cout << "size of my Set : " << mySet.size() << endl;
+    if (0 != sevens) {
+        const auto hands7 = randomHands7(sevens);
+        vector<poker::Value> values7(hands7.size());
+        cout << "  Seven cards" << endl;
+        cout << "    " << static_cast<uint64_t>(handsPerSecond(hands7, values7, reps)) << " hands/s" << endl;
+    }
 
-    return 0;
+    return EXIT_SUCCESS;
 }
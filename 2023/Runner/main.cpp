@@ -0,0 +1,227 @@
+/*
+ * Copyright © 2023 Brian Titus
+ * Contact: realcookiemonster69@gmail.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files(the “Software”), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and /or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+ * OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Advent of Code 2023
+// aoc2023: solves every day in one process, scheduling all parts on a shared thread pool
+//
+// Usage: aoc2023 [--day <name>]... [--threads <n>] [--root <dir>] [--timings]
+//                [--cache <dir>] [--no-cache]
+//
+// Answers are cached on disk when --cache or the AOC_CACHE environment variable names a
+// directory, keyed by the input and the binary (see Common/Cache.h); --no-cache ignores both.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <optional>
+#include <exception>
+#include <filesystem>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "../Common/Cache.h"
+#include "../Common/Input.h"
+#include "../Common/Solver.h"
+#include "../Common/ThreadPool.h"
+
+#ifndef AOC_SOURCE_DIR
+#define AOC_SOURCE_DIR "."
+#endif
+
+using namespace std;
+
+// Single-thread cost in ms of the slow parts, as measured by Harness; anything missing is
+// well below 100 ms. Only the ordering matters: the longest jobs must start first.
+struct ExpectedCost {
+    string_view name;
+    double part1;
+    double part2;
+};
+
+constexpr ExpectedCost expectedCosts[] = {
+        {"Day_23", 2200, 80000},
+        {"Day_25", 2800, 0},
+        {"Day_23B", 25, 2400},
+        {"Day_22", 130, 1650},
+        {"Day_12", 6, 400},
+        {"Day_17", 30, 92},
+        {"Day_21", 0, 65},
+        {"Day_14", 0, 50},
+        {"Day_16", 0, 13},
+        {"Day_8", 3, 21},
+};
+
+static double expectedCost(string_view name, int part) {
+    for (const auto &cost: expectedCosts) {
+        if (cost.name == name) {
+            return 1 == part ? cost.part1 : cost.part2;
+        }
+    }
+    return 0;
+}
+
+struct Job {
+    const aoc::Solution *solution;
+    int part;
+    string_view input;
+    filesystem::path entry{};        // in the result cache
+    optional<aoc::Answer> cached{};  // found in the result cache, so never scheduled
+    future<pair<aoc::Answer, double> > result{};
+};
+
+struct Options {
+    vector<string> days;
+    unsigned threads{thread::hardware_concurrency()};
+    filesystem::path root{AOC_SOURCE_DIR};
+    bool timings{false};
+    filesystem::path cache;
+    bool noCache{false};
+};
+
+static bool selected(const Options &options, const aoc::Solution &solution) {
+    if (options.days.empty()) {
+        return true;
+    }
+    return any_of(options.days.begin(), options.days.end(), [&](const string &day) {
+        return day == solution.name || "Day_" + day == solution.name;
+    });
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    if (const char *cache = getenv("AOC_CACHE")) {
+        options.cache = cache;
+    }
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        const auto hasValue = i + 1 < argc;
+        if ("--day" == arg && hasValue) {
+            options.days.emplace_back(argv[++i]);
+        } else if ("--threads" == arg && hasValue) {
+            options.threads = static_cast<unsigned>(max(1, stoi(argv[++i])));
+        } else if ("--root" == arg && hasValue) {
+            options.root = argv[++i];
+        } else if ("--timings" == arg) {
+            options.timings = true;
+        } else if ("--cache" == arg && hasValue) {
+            options.cache = argv[++i];
+        } else if ("--no-cache" == arg) {
+            options.noCache = true;
+        } else {
+            cerr << "Usage: " << argv[0] << " [--day <name>]... [--threads <n>] [--root <dir>] [--timings]"
+                 << " [--cache <dir>] [--no-cache]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    const auto start = chrono::steady_clock::now();
+
+    aoc::ResultCache cache;
+    if (!options.cache.empty() && !options.noCache) {
+        if (const auto build = aoc::ResultCache::buildIdentity(argv[0]); !build.empty()) {
+            cache = aoc::ResultCache(options.cache, build);
+        }
+    }
+
+    // Every input is mapped once and shared by both parts of its day
+    vector<aoc::MappedFile> inputs;
+    vector<Job> jobs;
+    inputs.reserve(aoc::solutions.size());
+    for (const auto &solution: aoc::solutions) {
+        if (!selected(options, solution)) {
+            continue;
+        }
+        auto &input = inputs.emplace_back((options.root / solution.input).string());
+        if (!input) {
+            return EXIT_FAILURE;
+        }
+        for (const int part: {1, 2}) {
+            auto &job = jobs.emplace_back(Job{&solution, part, input.view()});
+            if (cache) {
+                job.entry = cache.entry(solution.name, part, job.input);
+                job.cached = cache.load(job.entry);
+            }
+        }
+    }
+
+    // Longest expected job first, so the slowest part bounds the wall-clock time
+    vector<size_t> order(jobs.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return expectedCost(jobs[a].solution->name, jobs[a].part) > expectedCost(jobs[b].solution->name, jobs[b].part);
+    });
+
+    aoc::ThreadPool pool(options.threads);
+    for (const auto i: order) {
+        auto &job = jobs[i];
+        if (job.cached) {
+            continue;
+        }
+        const auto solve = 1 == job.part ? job.solution->part1 : job.solution->part2;
+        job.result = pool.submit([solve, input = job.input, &cache, &entry = job.entry] {
+            const auto begin = chrono::steady_clock::now();
+            auto answer = solve(input);
+            const chrono::duration<double, milli> elapsed = chrono::steady_clock::now() - begin;
+            cache.store(entry, answer);
+            return make_pair(std::move(answer), elapsed.count());
+        });
+    }
+
+    // Results are reported in day order, whatever order they finish in
+    auto status = EXIT_SUCCESS;
+    double cpuMs{};
+    size_t computed{};
+    for (auto &job: jobs) {
+        try {
+            const auto [answer, ms] = job.cached ? make_pair(*job.cached, 0.) : job.result.get();
+            cpuMs += ms;
+            computed += job.cached ? 0 : 1;
+            if (answer.empty()) {
+                continue;
+            }
+            cout << left << setw(8) << job.solution->name << " Part " << job.part << ": " << answer;
+            if (options.timings && job.cached) {
+                cout << "  (cached)";
+            } else if (options.timings) {
+                cout << "  (" << fixed << setprecision(3) << ms << " ms)";
+            }
+            cout << endl;
+        } catch (const exception &e) {
+            cerr << job.solution->name << " Part " << job.part << " failed: " << e.what() << endl;
+            status = EXIT_FAILURE;
+        }
+    }
+
+    if (options.timings) {
+        const chrono::duration<double, milli> wall = chrono::steady_clock::now() - start;
+        cerr << "Wall time " << fixed << setprecision(1) << wall.count() << " ms, sum of parts " << cpuMs
+             << " ms on " << pool.size() << " threads" << endl;
+    }
+    if (cache) {
+        cerr << "Cache " << options.cache.string() << ": " << jobs.size() - computed << " cached, " << computed
+             << " computed" << endl;
+    }
+    return status;
+}